@@ -61,6 +61,9 @@ project "Dynamite"
 		systemversion "latest"
 		staticruntime "on"
 
+		-- Note: Needed for std::thread on older glibc versions
+		links "pthread"
+
     filter "system:macosx"
 		defines "DY_PLATFORM_MACOS"
 		systemversion(MacOSVersion)
@@ -27,6 +27,24 @@ namespace Dynamite
 			if (str.substr(2, 2) == "O=")
 				return CompilerFlag(CompilerFlag::Type::OutputDir, str.substr(4, str.size() - 4));
 
+			if (str.substr(2, 2) == "J=")
+				return CompilerFlag(CompilerFlag::Type::Jobs, str.substr(4, str.size() - 4));
+
+			if (str.substr(2, 11) == "MaxNesting=")
+				return CompilerFlag(CompilerFlag::Type::MaxNesting, str.substr(13, str.size() - 13));
+
+			if (str.substr(2, str.size() - 2) == "Stream")
+				return CompilerFlag(CompilerFlag::Type::Stream);
+
+			if (str.substr(2, str.size() - 2) == "Lazy")
+				return CompilerFlag(CompilerFlag::Type::Lazy);
+
+			if (str.substr(2, str.size() - 2) == "HugePages")
+				return CompilerFlag(CompilerFlag::Type::HugePages);
+
+			if (str.substr(2, str.size() - 2) == "NoOptimize")
+				return CompilerFlag(CompilerFlag::Type::NoOptimize);
+
 			if (str.substr(2, str.size() - 2) == "Verbose")
 				return CompilerFlag(CompilerFlag::Type::Verbose);
 
@@ -3,21 +3,69 @@
 
 #include "Dynamite/Core/Logging.hpp"
 
+#include "Dynamite/Parsing/ConstantFolder.hpp"
+
+#include "Dynamite/IR/DeadCode.hpp"
+#include "Dynamite/IR/Lowering.hpp"
+#include "Dynamite/IR/ValueNumbering.hpp"
+#include "Dynamite/IR/Verifier.hpp"
+
+#include <atomic>
+#include <charconv>
+
 namespace Dynamite
 {
 
 	namespace
 	{
 		static CompilerSuite* s_Instance = nullptr;
+		thread_local static std::vector<Diagnostic>* s_DeferredDiagnostics = nullptr;
+		static std::atomic<size_t> s_ErrorCount = 0;
+
+		// Note: Returns 0 (all hardware threads) if no valid amount of jobs was specified.
+		static size_t GetJobCount(const CompilerOptions& options)
+		{
+			const std::vector<std::string> jobs = options.Get(CompilerFlag::Type::Jobs);
+			if (jobs.empty())
+				return 0;
+
+			size_t count = 0;
+			auto [ptr, error] = std::from_chars(jobs.back().data(), jobs.back().data() + jobs.back().size(), count);
+			if (error != std::errc() || ptr != jobs.back().data() + jobs.back().size())
+			{
+				DY_LOG_WARN("Invalid amount of jobs '{0}', using all hardware threads.", jobs.back());
+				return 0;
+			}
+
+			return count;
+		}
+
+		// Note: Returns the default if no valid nesting limit was specified.
+		static size_t GetMaxNesting(const CompilerOptions& options)
+		{
+			const std::vector<std::string> limits = options.Get(CompilerFlag::Type::MaxNesting);
+			if (limits.empty())
+				return Parser::DefaultMaxNesting;
+
+			size_t limit = 0;
+			auto [ptr, error] = std::from_chars(limits.back().data(), limits.back().data() + limits.back().size(), limit);
+			if (error != std::errc() || ptr != limits.back().data() + limits.back().size() || limit == 0)
+			{
+				DY_LOG_WARN("Invalid nesting limit '{0}', using the default of {1}.", limits.back(), Parser::DefaultMaxNesting);
+				return Parser::DefaultMaxNesting;
+			}
+
+			return limit;
+		}
 	}
 
 	CompilerSuite::CompilerSuite(const CompilerOptions& options)
-		: m_Options(options)
+		: m_Options(options), m_ThreadPool(GetJobCount(options)), m_CurrentArena(Arena::DefaultChunkSize, options.Contains(CompilerFlag::Type::HugePages))
 	{
 		s_Instance = this;
 
-		m_Tokenizer = Pulse::Unique<Tokenizer>::Create(m_CurrentFileContent);
-		m_Parser = Pulse::Unique<Parser>::Create(m_CurrentTokens);
+		m_Tokenizer = Pulse::Unique<Tokenizer>::Create(m_Sources, m_CurrentTokens, m_CurrentSymbols, m_ThreadPool);
+		m_Parser = Pulse::Unique<Parser>::Create(m_CurrentTokens, m_ThreadPool, GetMaxNesting(options), options.Contains(CompilerFlag::Type::Lazy));
 		m_Generator = Generator::Create(Generator::Type::ASM);
 	}
 
@@ -40,24 +88,82 @@ namespace Dynamite
 		for (const auto& file : files)
 		{
 			DY_LOG_TRACE("Compiling '{0}'.", file);
-			m_CurrentFile = file;
 
-			std::ifstream input(file);
-			
-			std::stringstream contentBuffer;
-			contentBuffer << input.rdbuf();
-			m_CurrentFileContent = contentBuffer.str();
+			const FileId fileId = m_Sources.Load(file);
+			if (fileId == InvalidFile)
+			{
+				DY_LOG_ERROR("Failed to open file '{0}'.", file);
+				continue;
+			}
+
+			const size_t errors = GetErrorCount();
+
+			// Note: Symbols & nodes are per compilation unit.
+			m_CurrentSymbols.Clear();
+			m_CurrentArena.Reset();
+			Node::SetArena(&m_CurrentArena);
 
 			// Note: Because the tokenizer and parser keep references to
-			// member variables we don't need to pass in anything.
-			m_CurrentState = State::Tokenizing;
-			m_CurrentTokens = m_Tokenizer->Tokenize();
+			// member variables we only need to pass in the file.
+
+			// Note: When streaming the parser pulls tokens from the tokenizer as it
+			// needs them, so the tokens are never stored (and can't be tokenized in parallel).
+			const bool stream = m_Options.Contains(CompilerFlag::Type::Stream);
+			if (stream)
+			{
+				m_CurrentState = State::Parsing;
+				m_Tokenizer->BeginStream(fileId);
+				m_CurrentProgram = m_Parser->GetProgram(*m_Tokenizer);
+			}
+			else
+			{
+				m_CurrentState = State::Tokenizing;
+				m_Tokenizer->Tokenize(fileId);
 
+				m_CurrentState = State::Parsing;
+				m_CurrentProgram = m_Parser->GetProgram();
+			}
+
+			// Note: Lazy bodies are parsed by the first pass that rewrites them, so their errors are reported then.
+			const bool optimize = !m_Options.Contains(CompilerFlag::Type::NoOptimize);
+			size_t folded = 0, removedBranches = 0, removedStatements = 0, removedSubexpressions = 0, removedInstructions = 0;
+			if (optimize)
+			{
+				m_CurrentState = State::Optimizing;
+				ConstantFolder folder(m_CurrentProgram);
+				folded = folder.Fold();
+				removedBranches = folder.RemovedBranchCount();
+				removedStatements = folder.RemovedStatementCount();
+			}
+
+			// Note: The bodies that no pass expanded are parsed before lowering, so lazy
+			// parsing doesn't change which programs are accepted.
 			m_CurrentState = State::Parsing;
-			m_CurrentProgram = m_Parser->GetProgram();
+			m_CurrentProgram.Expand();
+
+			m_CurrentState = State::Lowering;
+			m_CurrentModule = IR::Lowering(m_CurrentProgram).Lower();
 
-			m_CurrentState = State::Generating;
-			m_Generator->Generate(m_CurrentProgram, outputDir / std::filesystem::path(file).filename());
+			if (optimize)
+			{
+				m_CurrentState = State::Optimizing;
+				removedSubexpressions = IR::RemoveCommonSubexpressions(m_CurrentModule);
+				removedInstructions = IR::RemoveDeadCode(m_CurrentModule);
+			}
+
+			// Note: Only programs without errors are generated.
+			bool generate = (GetErrorCount() == errors);
+			#if !defined(DY_CONFIG_DIST)
+				generate = generate && IR::Verify(m_CurrentModule);
+			#endif
+
+			if (generate)
+			{
+				m_CurrentState = State::Generating;
+				m_Generator->Generate(m_CurrentModule, outputDir / std::filesystem::path(file).filename());
+			}
+			else
+				DY_LOG_ERROR("Failed to compile '{0}', no output was generated.", file);
 
 			// Log extra info when verbosity is enabled
 			if (m_Options.Contains(CompilerFlag::Type::Verbose))
@@ -66,16 +172,54 @@ namespace Dynamite
 				DY_LOG_TRACE("-- Tokens generated.");
 				DY_LOG_TRACE("---------------------------------------");
 
-				for (const auto& token : m_CurrentTokens)
-					DY_LOG_TRACE(FormatToken(token));
+				if (stream)
+					DY_LOG_TRACE("Tokens were streamed to the parser and not stored.");
+				else
+				{
+					for (size_t i = 0; i < m_CurrentTokens.Size(); i++)
+						DY_LOG_TRACE(FormatToken(m_CurrentTokens.Get(i)));
+				}
 
 				DY_LOG_TRACE("---------------------------------------");
 				DY_LOG_TRACE("-- Tree generated.");
 				DY_LOG_TRACE("---------------------------------------");
 
-				for (const auto& statement : m_CurrentProgram.Statements)
-					DY_LOG_TRACE(Node::FormatStatementData(statement));
+				for (const Node::Reference<Node::Statement> statement : m_CurrentProgram.GetStatements())
+					DY_LOG_TRACE(Node::FormatStatementData(m_CurrentProgram, statement));
+
+				DY_LOG_TRACE("---------------------------------------");
+				DY_LOG_TRACE("-- IR generated.");
+				DY_LOG_TRACE("---------------------------------------");
+
+				size_t blocks = 0, instructions = 0;
+				for (const IR::Function& function : m_CurrentModule.Functions)
+				{
+					DY_LOG_TRACE("{0}:", function.GetName());
+					for (uint32_t i = 0; i < function.BlockCount(); i++)
+					{
+						DY_LOG_TRACE(IR::FormatBlock(function, { i }));
+						for (const IR::Value value : function.GetBlock({ i }).Instructions)
+							DY_LOG_TRACE(IR::FormatInstruction(function, value));
+					}
+
+					// Note: Removed instructions are still part of the function.
+					blocks += function.BlockCount();
+					for (uint32_t i = 0; i < function.BlockCount(); i++)
+						instructions += function.GetBlock({ i }).Instructions.size();
+				}
+
+				const Arena::Statistics& statistics = m_CurrentArena.GetStatistics();
+				DY_LOG_TRACE("---------------------------------------");
+				DY_LOG_TRACE("-- Tree: {0} expressions & {1} statements in {2} bytes.", m_CurrentProgram.ExpressionCount(), m_CurrentProgram.StatementCount(), m_CurrentProgram.GetMemoryUsage());
+				DY_LOG_TRACE("-- Folded: {0} expression(s), removed {1} branch(es) & {2} unreachable statement(s).", folded, removedBranches, removedStatements);
+				DY_LOG_TRACE("-- IR: {0} instructions in {1} block(s), removed {2} common subexpression(s) & {3} dead instruction(s).", instructions, blocks, removedSubexpressions, removedInstructions);
+				DY_LOG_TRACE("-- Arena: {0} bytes allocated, {1} bytes reserved in {2} chunk(s), high-water mark {3} bytes{4}.", statistics.BytesAllocated, statistics.BytesReserved, statistics.ChunkCount, statistics.HighWaterMark, (m_CurrentArena.UsesHugePages() ? " (huge pages)" : ""));
+				DY_LOG_TRACE("---------------------------------------");
 			}
+
+			// Note: Sources are per compilation unit as well, so only the current file is
+			// mapped and the 32 bit locations limit the size of a file instead of all of them.
+			m_Sources.Clear();
 		}
 	}
 
@@ -84,31 +228,35 @@ namespace Dynamite
 		return *s_Instance;
 	}
 
-	const std::string CompilerSuite::GetCurrentLine(uint32_t line) const
+	void CompilerSuite::DeferDiagnostics(std::vector<Diagnostic>* diagnostics)
 	{
-		// Find the start of the line by counting newlines
-		size_t currentLine = 1;
-		size_t start = 0;
+		s_DeferredDiagnostics = diagnostics;
+	}
 
-		while (currentLine < line && start != std::string::npos)
-		{
-			start = m_CurrentFileContent.find_first_of("\n\r", start + 1);
-			currentLine++;
-		}
+	void CompilerSuite::Report(const std::vector<Diagnostic>& diagnostics)
+	{
+		for (const Diagnostic& diagnostic : diagnostics)
+			Report(diagnostic.Level, diagnostic.Message);
+	}
 
-		// If the line was not found, return an empty string
-		if (start == std::string::npos)
-			return "";
+	size_t CompilerSuite::GetErrorCount()
+	{
+		return s_ErrorCount;
+	}
 
-		// Move to the start of the next line
-		start++;
+	void CompilerSuite::Report(LogLevel logLevel, const std::string& message)
+	{
+		if (s_DeferredDiagnostics)
+		{
+			s_DeferredDiagnostics->emplace_back(logLevel, message);
+			return;
+		}
 
-		// Find the end of the line
-		size_t end = m_CurrentFileContent.find_first_of("\n\r", start);
-		if (end == std::string::npos)
-			end = m_CurrentFileContent.size();
+		// Note: Deferred diagnostics are counted once they're reported.
+		if (logLevel == LogLevel::Error)
+			s_ErrorCount++;
 
-		return m_CurrentFileContent.substr(start, end - start);
+		Logger::LogMessage(logLevel, "{0}", message);
 	}
 
 }
\ No newline at end of file
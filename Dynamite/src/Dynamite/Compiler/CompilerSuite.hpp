@@ -1,12 +1,16 @@
 #pragma once
 
+#include "Dynamite/Core/Arena.hpp"
 #include "Dynamite/Core/Logging.hpp"
+#include "Dynamite/Core/ThreadPool.hpp"
 
 #include "Dynamite/Tokens/Tokenizer.hpp"
 #include "Dynamite/Parsing/Parser.hpp"
+#include "Dynamite/IR/IR.hpp"
 #include "Dynamite/Generator/Generator.hpp"
 
 #include "Dynamite/Compiler/CompilerOptions.hpp"
+#include "Dynamite/Compiler/SourceManager.hpp"
 
 #include <Pulse/Core/Unique.hpp>
 #include <Pulse/Text/Format.hpp>
@@ -16,15 +20,24 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <optional>
+#include <vector>
 
 namespace Dynamite
 {
 
+	struct Diagnostic
+	{
+	public:
+		LogLevel Level = LogLevel::None;
+		std::string Message = {};
+	};
+
 	class CompilerSuite
 	{
 	public:
-		enum class State : uint8_t { Tokenizing, Parsing, Generating };
+		enum class State : uint8_t { Tokenizing, Parsing, Optimizing, Lowering, Generating };
 	public:
 		CompilerSuite(const CompilerOptions& options);
 		~CompilerSuite();
@@ -37,41 +50,65 @@ namespace Dynamite
 		static CompilerSuite& Get();
 
 	public:
-		const std::string GetCurrentLine(uint32_t line) const;
-
 		inline const State GetState() const { return m_CurrentState; }
-		inline const std::filesystem::path& GetCurrentFile() const { return m_CurrentFile; }
+		inline const SourceManager& GetSources() const { return m_Sources; }
+		inline const Interner& GetCurrentSymbols() const { return m_CurrentSymbols; }
 
 	public:
 		template<typename ...Args>
-		static void Print(LogLevel logLevel, uint32_t line, const std::string& fmt, Args&& ...args);
+		static void Print(LogLevel logLevel, SourceLocation location, const std::string& fmt, Args&& ...args);
 
 		template<typename ...Args>
-		static void Warn(uint32_t line, const std::string& fmt, Args&& ...args) { Print<Args...>(LogLevel::Warn, line, fmt, std::forward<Args>(args)...); }
+		static void Warn(SourceLocation location, const std::string& fmt, Args&& ...args) { Print<Args...>(LogLevel::Warn, location, fmt, std::forward<Args>(args)...); }
 		template<typename ...Args>
-		static void Error(uint32_t line, const std::string& fmt, Args&& ...args) { Print<Args...>(LogLevel::Error, line, fmt, std::forward<Args>(args)...); }
+		static void Error(SourceLocation location, const std::string& fmt, Args&& ...args) { Print<Args...>(LogLevel::Error, location, fmt, std::forward<Args>(args)...); }
+
+		// Note: While set, the diagnostics of the current thread are stored in diagnostics instead
+		// of logged, so work done in parallel can report them in a deterministic order.
+		static void DeferDiagnostics(std::vector<Diagnostic>* diagnostics);
+		static void Report(const std::vector<Diagnostic>& diagnostics);
+
+		// Note: The amount of errors reported since the start of the program.
+		static size_t GetErrorCount();
+
+	private:
+		static void Report(LogLevel logLevel, const std::string& message);
 
 	private:
 		const CompilerOptions m_Options;
 		State m_CurrentState = State::Tokenizing;
 
+		ThreadPool m_ThreadPool;
+
 		Pulse::Unique<Tokenizer> m_Tokenizer = nullptr;
 		Pulse::Unique<Parser> m_Parser = nullptr;
 		Pulse::Unique<Generator> m_Generator = nullptr;
 
-		std::filesystem::path m_CurrentFile = {};
-		std::string m_CurrentFileContent = {};
-		std::vector<Token> m_CurrentTokens = { };
+		SourceManager m_Sources = {};
+		Arena m_CurrentArena;
+		Interner m_CurrentSymbols = { };
+		TokenStream m_CurrentTokens = { };
 		Node::Program m_CurrentProgram = {};
+		IR::Module m_CurrentModule = {};
 	};
 
 	template<typename ...Args>
-	void CompilerSuite::Print(LogLevel logLevel, uint32_t line, const std::string& fmt, Args&& ...args)
+	void CompilerSuite::Print(LogLevel logLevel, SourceLocation location, const std::string& fmt, Args&& ...args)
 	{
 		CompilerSuite& instance = Get();
+		const SourceManager& sources = instance.GetSources();
 
 		std::string str = Pulse::Text::Format(fmt, std::forward<Args>(args)...);
-		Logger::LogMessage(logLevel, "While {0}:\n    {1}\n\n    Line: {2}\n    File: {3}:{4}", Pulse::Enum::Name(instance.GetState()), str, instance.GetCurrentLine(line), instance.GetCurrentFile().string(), line);
+
+		// Note: Decoding is a binary search over the files and lines.
+		const DecodedLocation decoded = sources.Decode(location);
+		if (decoded.File == InvalidFile)
+		{
+			Report(logLevel, Pulse::Text::Format("While {0}:\n    {1}", Pulse::Enum::Name(instance.GetState()), str));
+			return;
+		}
+
+		Report(logLevel, Pulse::Text::Format("While {0}:\n    {1}\n\n    Line: {2}\n    File: {3}:{4}:{5}", Pulse::Enum::Name(instance.GetState()), str, sources.GetLine(location), sources.GetPath(decoded.File).string(), decoded.Line, decoded.Column));
 	}
 
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "dypch.h"
+#include "SourceFile.hpp"
+
+#include "Dynamite/Core/Logging.hpp"
+
+#if defined(DY_PLATFORM_LINUX) || defined(DY_PLATFORM_MACOS)
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+namespace Dynamite
+{
+
+	namespace
+	{
+		// Note: Below this size mapping costs more than just reading.
+		constexpr static const size_t s_MinMappingSize = 64ull * 1024; // 64 KB
+	}
+
+	SourceFile::~SourceFile()
+	{
+		Close();
+	}
+
+	#if defined(DY_PLATFORM_LINUX) || defined(DY_PLATFORM_MACOS)
+	bool SourceFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+
+		struct stat info = {};
+		if (::fstat(fd, &info) != 0)
+		{
+			::close(fd);
+			return false;
+		}
+
+		const bool regular = S_ISREG(info.st_mode);
+		const size_t size = static_cast<size_t>(info.st_size);
+
+		// Memory mapping
+		if (regular && size >= s_MinMappingSize)
+		{
+			void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping != MAP_FAILED)
+			{
+				::madvise(mapping, size, MADV_SEQUENTIAL);
+				::close(fd);
+
+				m_Mapping = mapping;
+				m_MappingSize = size;
+				m_Content = std::string_view(static_cast<const char*>(mapping), size);
+				return true;
+			}
+		}
+
+		// Single read (or until the end for pipes, since their size is unknown)
+		m_Buffer.resize(regular ? size : s_MinMappingSize);
+
+		size_t offset = 0;
+		while (true)
+		{
+			if (offset == m_Buffer.size())
+			{
+				if (regular)
+					break;
+
+				m_Buffer.resize(m_Buffer.size() * 2);
+			}
+
+			ssize_t count = ::read(fd, m_Buffer.data() + offset, m_Buffer.size() - offset);
+			if (count < 0)
+			{
+				::close(fd);
+				m_Buffer.clear();
+				return false;
+			}
+			if (count == 0)
+				break;
+
+			offset += static_cast<size_t>(count);
+		}
+
+		::close(fd);
+
+		m_Buffer.resize(offset);
+		m_Content = m_Buffer;
+		return true;
+	}
+
+	void SourceFile::Close()
+	{
+		if (m_Mapping)
+			::munmap(m_Mapping, m_MappingSize);
+
+		m_Mapping = nullptr;
+		m_MappingSize = 0;
+
+		m_Buffer.clear();
+		m_Content = {};
+	}
+	#else
+	bool SourceFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+		std::ifstream input(path, std::ios::binary | std::ios::ate);
+		if (!input.is_open())
+			return false;
+
+		m_Buffer.resize(static_cast<size_t>(input.tellg()));
+		input.seekg(0);
+		input.read(m_Buffer.data(), m_Buffer.size());
+
+		m_Buffer.resize(static_cast<size_t>(input.gcount()));
+		m_Content = m_Buffer;
+		return true;
+	}
+
+	void SourceFile::Close()
+	{
+		m_Buffer.clear();
+		m_Content = {};
+	}
+	#endif
+
+}
\ No newline at end of file
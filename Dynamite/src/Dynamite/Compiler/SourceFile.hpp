@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <filesystem>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// SourceFile
+	/////////////////////////////////////////////////////////////////
+	// Note: Regular files are memory mapped (read-only), small files
+	// and pipes are read with a single read into an owned buffer.
+	class SourceFile
+	{
+	public:
+		SourceFile() = default;
+		~SourceFile();
+
+		SourceFile(const SourceFile&) = delete;
+		SourceFile& operator = (const SourceFile&) = delete;
+
+		// Returns false if the file could not be opened/read.
+		bool Open(const std::filesystem::path& path);
+		void Close();
+
+		// Note: Only valid until the file is closed or another file is opened.
+		inline std::string_view GetContent() const { return m_Content; }
+		inline bool IsMapped() const { return m_Mapping != nullptr; }
+
+	private:
+		std::string_view m_Content = {};
+
+		void* m_Mapping = nullptr;
+		size_t m_MappingSize = 0;
+
+		std::string m_Buffer = {};
+	};
+
+}
\ No newline at end of file
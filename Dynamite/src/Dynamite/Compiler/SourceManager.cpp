@@ -0,0 +1,98 @@
+#include "dypch.h"
+#include "SourceManager.hpp"
+
+#include "Dynamite/Core/Logging.hpp"
+
+#include "Dynamite/Tokens/Scanning.hpp"
+
+namespace Dynamite
+{
+
+	FileId SourceManager::Load(const std::filesystem::path& path)
+	{
+		File& file = m_Files.emplace_back();
+		file.Path = path;
+
+		if (!file.Source.Open(path))
+		{
+			m_Files.pop_back();
+			return InvalidFile;
+		}
+
+		// Note: Every file reserves one extra offset, so the end of the file is a valid location.
+		const size_t size = file.Source.GetContent().size() + 1;
+		if (size > static_cast<size_t>(std::numeric_limits<uint32_t>::max() - m_NextBase))
+		{
+			DY_LOG_ERROR("Source file '{0}' is too large, maximum size (of the files loaded together) is {1} bytes.", path.string(), std::numeric_limits<uint32_t>::max());
+
+			m_Files.pop_back();
+			return InvalidFile;
+		}
+
+		file.Base = m_NextBase;
+		file.LineStarts.assign(1, 0);
+		m_NextBase += static_cast<uint32_t>(size);
+
+		return static_cast<FileId>(m_Files.size() - 1);
+	}
+
+	void SourceManager::Clear()
+	{
+		m_Files.clear();
+		m_NextBase = 1;
+	}
+
+	std::vector<uint32_t>& SourceManager::ResetLineStarts(FileId file)
+	{
+		std::vector<uint32_t>& lineStarts = m_Files[file].LineStarts;
+		lineStarts.assign(1, 0);
+
+		return lineStarts;
+	}
+
+	FileId SourceManager::GetFile(SourceLocation location) const
+	{
+		if (!location.IsValid() || m_Files.empty())
+			return InvalidFile;
+
+		// Note: The last file whose base is at or before the location.
+		auto it = std::upper_bound(m_Files.begin(), m_Files.end(), location.Offset, [](uint32_t offset, const File& file) { return offset < file.Base; });
+		if (it == m_Files.begin())
+			return InvalidFile;
+
+		return static_cast<FileId>(std::distance(m_Files.begin(), it) - 1);
+	}
+
+	DecodedLocation SourceManager::Decode(SourceLocation location) const
+	{
+		const FileId file = GetFile(location);
+		if (file == InvalidFile)
+			return {};
+
+		const std::vector<uint32_t>& lineStarts = m_Files[file].LineStarts;
+		const uint32_t offset = location.Offset - m_Files[file].Base;
+
+		// Note: The last line that starts at or before the offset.
+		auto it = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+		const uint32_t line = static_cast<uint32_t>(std::distance(lineStarts.begin(), it));
+
+		return { file, line, offset - lineStarts[line - 1] + 1 };
+	}
+
+	std::string_view SourceManager::GetLine(SourceLocation location) const
+	{
+		const DecodedLocation decoded = Decode(location);
+		if (decoded.File == InvalidFile)
+			return {};
+
+		const std::string_view content = GetContent(decoded.File);
+		const size_t start = std::min<size_t>(m_Files[decoded.File].LineStarts[decoded.Line - 1], content.size());
+		size_t end = Scanning::FindLineEnd(content, start);
+
+		if (end > start && content[end - 1] == '\r')
+			end--;
+
+		return content.substr(start, end - start);
+	}
+
+}
\ No newline at end of file
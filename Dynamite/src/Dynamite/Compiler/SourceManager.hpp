@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Dynamite/Core/SourceLocation.hpp"
+
+#include "Dynamite/Compiler/SourceFile.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <string_view>
+#include <filesystem>
+
+namespace Dynamite
+{
+
+	// Index of a file loaded by the SourceManager.
+	using FileId = uint32_t;
+
+	constexpr const FileId InvalidFile = static_cast<FileId>(-1);
+
+	// Note: Line & column start at 1.
+	struct DecodedLocation
+	{
+	public:
+		FileId File = InvalidFile;
+		uint32_t Line = 0;
+		uint32_t Column = 0;
+	};
+
+	/////////////////////////////////////////////////////////////////
+	// SourceManager
+	/////////////////////////////////////////////////////////////////
+	// Note: Owns every loaded file and its line table (the offset of
+	// the start of every line), which is filled by the tokenizer.
+	// Lines are terminated by '\n', so "\r\n" counts as one line.
+	class SourceManager
+	{
+	public:
+		SourceManager() = default;
+		~SourceManager() = default;
+
+		// Returns InvalidFile if the file could not be opened/read.
+		FileId Load(const std::filesystem::path& path);
+		// Note: Closes every file, which invalidates all FileId's and SourceLocation's.
+		void Clear();
+
+		// Note: Clears the line table of file and returns it, so it can be (re)filled while tokenizing.
+		std::vector<uint32_t>& ResetLineStarts(FileId file);
+
+		// Locations
+		inline SourceLocation GetLocation(FileId file, uint32_t offset) const { return { m_Files[file].Base + offset }; }
+
+		FileId GetFile(SourceLocation location) const;
+		DecodedLocation Decode(SourceLocation location) const;
+		// Returns the full line the location is on, without the newline.
+		std::string_view GetLine(SourceLocation location) const;
+
+		// Getters
+		inline const std::filesystem::path& GetPath(FileId file) const { return m_Files[file].Path; }
+		inline std::string_view GetContent(FileId file) const { return m_Files[file].Source.GetContent(); }
+		inline size_t Size() const { return m_Files.size(); }
+
+	private:
+		struct File
+		{
+		public:
+			std::filesystem::path Path = {};
+			SourceFile Source = {};
+
+			// Note: Location of the first character.
+			uint32_t Base = 0;
+			std::vector<uint32_t> LineStarts = { };
+		};
+
+	private:
+		// Note: A deque, since SourceFile's can't be moved.
+		std::deque<File> m_Files = { };
+
+		uint32_t m_NextBase = 1;
+	};
+
+}
\ No newline at end of file
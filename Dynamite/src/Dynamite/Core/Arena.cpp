@@ -0,0 +1,152 @@
+#include "dypch.h"
+#include "Arena.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(DY_PLATFORM_LINUX)
+	#include <sys/mman.h>
+#endif
+
+namespace Dynamite
+{
+
+	namespace
+	{
+		// Note: Every new chunk is double the size of the last, up to 64x the initial size.
+		constexpr static const size_t s_MaxGrowthShift = 6;
+		constexpr static const size_t s_HugePageSize = 2ull * 1024 * 1024; // 2 MB
+
+		inline size_t AlignUp(size_t value, size_t alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// Main functions
+	/////////////////////////////////////////////////////////////////
+	Arena::Arena(size_t chunkSize, bool hugePages)
+		: m_ChunkSize(std::max<size_t>(chunkSize, 1)), m_HugePages(hugePages)
+	{
+	}
+
+	Arena::~Arena()
+	{
+		Release();
+	}
+
+	void* Arena::Allocate(size_t size, size_t alignment)
+	{
+		// Note: Alignment is done on the address, since chunks are only aligned to max_align_t.
+		auto alignedOffset = [&]() -> size_t
+		{
+			const uintptr_t base = reinterpret_cast<uintptr_t>(m_Chunks[m_Current].Data);
+			return AlignUp(base + m_Offset, alignment) - base;
+		};
+
+		if (m_Chunks.empty() || alignedOffset() + size > m_Chunks[m_Current].Size)
+			NextChunk(size, alignment);
+
+		const size_t offset = alignedOffset();
+
+		m_Statistics.BytesAllocated += (offset - m_Offset) + size;
+		m_Statistics.HighWaterMark = std::max(m_Statistics.HighWaterMark, m_Statistics.BytesAllocated);
+
+		m_Offset = offset + size;
+		return m_Chunks[m_Current].Data + offset;
+	}
+
+	void Arena::Reset()
+	{
+		m_Current = 0;
+		m_Offset = 0;
+
+		m_Statistics.BytesAllocated = 0;
+	}
+
+	void Arena::Release()
+	{
+		for (const Chunk& chunk : m_Chunks)
+			FreeChunk(chunk);
+
+		m_Chunks.clear();
+		Reset();
+
+		m_Statistics.BytesReserved = 0;
+		m_Statistics.ChunkCount = 0;
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// Private functions
+	/////////////////////////////////////////////////////////////////
+	void Arena::NextChunk(size_t size, size_t alignment)
+	{
+		const size_t required = size + alignment;
+		const size_t next = (m_Chunks.empty() ? 0 : m_Current + 1);
+
+		// Note: After a reset the existing chunks get reused, a chunk that is
+		// too small is moved back so it can still be used for later allocations.
+		for (size_t i = next; i < m_Chunks.size(); i++)
+		{
+			if (m_Chunks[i].Size < required)
+				continue;
+
+			std::swap(m_Chunks[i], m_Chunks[next]);
+
+			m_Current = next;
+			m_Offset = 0;
+			return;
+		}
+
+		const size_t growth = m_ChunkSize << std::min(m_Chunks.size(), s_MaxGrowthShift);
+		const Chunk chunk = AllocateChunk(std::max(required, growth));
+
+		m_Chunks.insert(m_Chunks.begin() + next, chunk);
+		m_Statistics.BytesReserved += chunk.Size;
+		m_Statistics.ChunkCount++;
+
+		m_Current = next;
+		m_Offset = 0;
+	}
+
+	Arena::Chunk Arena::AllocateChunk(size_t size)
+	{
+		#if defined(DY_PLATFORM_LINUX)
+		if (m_HugePages)
+		{
+			const size_t mappingSize = AlignUp(size, s_HugePageSize);
+
+			void* mapping = ::mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (mapping != MAP_FAILED)
+			{
+				#if defined(MADV_HUGEPAGE)
+				::madvise(mapping, mappingSize, MADV_HUGEPAGE);
+				#endif
+
+				return { static_cast<std::byte*>(mapping), mappingSize, true };
+			}
+		}
+		#endif
+
+		void* data = std::malloc(size);
+		if (!data)
+			throw std::bad_alloc();
+
+		return { static_cast<std::byte*>(data), size, false };
+	}
+
+	void Arena::FreeChunk(const Chunk& chunk)
+	{
+		#if defined(DY_PLATFORM_LINUX)
+		if (chunk.Mapped)
+		{
+			::munmap(chunk.Data, chunk.Size);
+			return;
+		}
+		#endif
+
+		std::free(chunk.Data);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// Arena
+	/////////////////////////////////////////////////////////////////
+	// Note: A bump allocator made of chunks, when a chunk is full a new
+	// one (of double the size) gets added so it never runs out. Destructors
+	// are never run, everything is freed at once with Reset() or Release().
+	class Arena
+	{
+	public:
+		struct Statistics
+		{
+		public:
+			size_t BytesAllocated = 0;	// Since the last reset, including alignment padding
+			size_t BytesReserved = 0;	// Total size of all chunks
+			size_t ChunkCount = 0;
+			size_t HighWaterMark = 0;	// Most bytes allocated between resets
+		};
+
+	public:
+		constexpr static const size_t DefaultChunkSize = 1024ull * 1024; // 1 MB
+
+		// Note: With hugePages chunks are backed by (transparent) huge pages
+		// where the platform supports it, falls back to normal pages otherwise.
+		Arena(size_t chunkSize = DefaultChunkSize, bool hugePages = false);
+		~Arena();
+
+		Arena(const Arena&) = delete;
+		Arena& operator = (const Arena&) = delete;
+
+		// Never returns nullptr.
+		[[nodiscard]] void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T, typename ...TArgs>
+		T* Construct(TArgs&& ...args);
+
+		// Note: Invalidates all allocations, keeps the chunks to be reused.
+		void Reset();
+		// Note: Invalidates all allocations and frees all chunks.
+		void Release();
+
+		// Getters
+		inline const Statistics& GetStatistics() const { return m_Statistics; }
+		inline bool UsesHugePages() const { return m_HugePages; }
+
+	private:
+		struct Chunk
+		{
+		public:
+			std::byte* Data = nullptr;
+			size_t Size = 0;
+
+			bool Mapped = false; // Allocated with mmap (for huge pages) instead of malloc
+		};
+
+		// Moves to the next chunk that can hold size bytes, adds one if there is none.
+		void NextChunk(size_t size, size_t alignment);
+
+		Chunk AllocateChunk(size_t size);
+		void FreeChunk(const Chunk& chunk);
+
+	private:
+		size_t m_ChunkSize;
+		bool m_HugePages;
+
+		std::vector<Chunk> m_Chunks = { };
+		size_t m_Current = 0;
+		size_t m_Offset = 0;
+
+		Statistics m_Statistics = { };
+	};
+
+	/////////////////////////////////////////////////////////////////
+	// Templated functions
+	/////////////////////////////////////////////////////////////////
+	template<typename T, typename ...TArgs>
+	T* Arena::Construct(TArgs&& ...args)
+	{
+		void* memory = Allocate(sizeof(T), alignof(T));
+		return new (memory) T(std::forward<TArgs>(args)...);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Dynamite/Core/Arena.hpp"
+#include "Dynamite/Core/ArenaVector.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// ArenaPool
+	/////////////////////////////////////////////////////////////////
+	// Note: An append only array addressed by 32 bit indices, stored in fixed
+	// size segments from an Arena. Unlike ArenaVector growing never copies,
+	// so no arena memory is wasted and elements never move.
+	template<typename T>
+	class ArenaPool
+	{
+	public:
+		static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "ArenaPool only supports trivial types.");
+
+		ArenaPool() = default;
+		ArenaPool(Arena& arena)
+			: m_Arena(&arena), m_Segments(arena) {}
+		~ArenaPool() = default;
+
+		// Returns the index of the new element.
+		uint32_t Push(const T& value)
+		{
+			if ((m_Size >> s_Shift) == m_Segments.Size())
+				m_Segments.Push(static_cast<T*>(m_Arena->Allocate(s_SegmentSize * sizeof(T), alignof(T))));
+
+			m_Segments[m_Size >> s_Shift][m_Size & s_Mask] = value;
+			return m_Size++;
+		}
+
+		// Note: New elements have to be assigned, elements past the old
+		// size can be assigned from different threads.
+		void Resize(uint32_t size)
+		{
+			while ((static_cast<size_t>(m_Segments.Size()) << s_Shift) < size)
+				m_Segments.Push(static_cast<T*>(m_Arena->Allocate(s_SegmentSize * sizeof(T), alignof(T))));
+
+			m_Size = size;
+		}
+
+		// Getters
+		inline T& operator [] (uint32_t index) { return m_Segments[index >> s_Shift][index & s_Mask]; }
+		inline const T& operator [] (uint32_t index) const { return m_Segments[index >> s_Shift][index & s_Mask]; }
+
+		inline uint32_t Size() const { return m_Size; }
+		inline bool Empty() const { return m_Size == 0; }
+
+		inline size_t GetMemoryUsage() const { return m_Segments.Size() * s_SegmentSize * sizeof(T); }
+
+	private:
+		// Note: Segments are ~1 KB, rounded down to a power of two elements
+		// so an index is split into a segment & offset with a shift and mask.
+		constexpr static const size_t s_SegmentSize = std::bit_floor(std::max<size_t>(1024 / sizeof(T), 1));
+		constexpr static const uint32_t s_Shift = static_cast<uint32_t>(std::countr_zero(s_SegmentSize));
+		constexpr static const uint32_t s_Mask = static_cast<uint32_t>(s_SegmentSize - 1);
+
+		Arena* m_Arena = nullptr;
+		ArenaVector<T*> m_Segments = { };
+
+		uint32_t m_Size = 0;
+	};
+
+}
\ No newline at end of file
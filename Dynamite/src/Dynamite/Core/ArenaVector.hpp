@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Dynamite/Core/Arena.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// ArenaVector
+	/////////////////////////////////////////////////////////////////
+	// Note: A growable array whose storage lives in an Arena. Growing copies
+	// the elements to a new block, the old block is freed with the arena.
+	// Since nothing is ever destroyed, copies are shallow and T must be trivial.
+	// A default constructed ArenaVector has no arena and must stay empty.
+	template<typename T>
+	class ArenaVector
+	{
+	public:
+		static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "ArenaVector only supports trivial types.");
+
+		ArenaVector() = default;
+		ArenaVector(Arena& arena)
+			: m_Arena(&arena) {}
+		~ArenaVector() = default;
+
+		void Push(const T& value)
+		{
+			if (m_Size == m_Capacity)
+				Reserve(std::max<size_t>(s_MinCapacity, static_cast<size_t>(m_Capacity) * 2));
+
+			m_Data[m_Size++] = value;
+		}
+
+		void Reserve(size_t capacity)
+		{
+			if (capacity <= m_Capacity)
+				return;
+
+			T* data = static_cast<T*>(m_Arena->Allocate(capacity * sizeof(T), alignof(T)));
+			if (m_Size != 0)
+				std::memcpy(data, m_Data, m_Size * sizeof(T));
+
+			m_Data = data;
+			m_Capacity = static_cast<uint32_t>(capacity);
+		}
+
+		inline void Clear() { m_Size = 0; }
+
+		// Getters
+		inline T& operator [] (size_t index) { return m_Data[index]; }
+		inline const T& operator [] (size_t index) const { return m_Data[index]; }
+
+		inline T* Data() { return m_Data; }
+		inline const T* Data() const { return m_Data; }
+
+		inline size_t Size() const { return m_Size; }
+		inline bool Empty() const { return m_Size == 0; }
+
+		// Iterators
+		inline T* begin() { return m_Data; }
+		inline T* end() { return m_Data + m_Size; }
+		inline const T* begin() const { return m_Data; }
+		inline const T* end() const { return m_Data + m_Size; }
+
+	private:
+		constexpr static const size_t s_MinCapacity = 4;
+
+		Arena* m_Arena = nullptr;
+
+		T* m_Data = nullptr;
+		uint32_t m_Size = 0;
+		uint32_t m_Capacity = 0;
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// Branch values
+	/////////////////////////////////////////////////////////////////
+	// Note: Keeps the value of every variable slot through if statements. The slots
+	// are never reused so they are numbered in declaration order. The assignments in a
+	// branch are undone when it ends, so the next branch starts with the values from
+	// before the if statement. The final values of the branches that continue after
+	// the if statement are kept, so they can be joined when the if statement ends.
+	template<typename T>
+	class BranchValues
+	{
+	public:
+		BranchValues() = default;
+		~BranchValues() = default;
+
+		// Returns the slot of a new variable.
+		uint32_t Add(const T& value)
+		{
+			m_Values.push_back(value);
+			m_Marks.push_back(0);
+			m_Gathered.push_back(0);
+
+			return static_cast<uint32_t>(m_Values.size() - 1);
+		}
+
+		void Assign(uint32_t slot, const T& value)
+		{
+			// Note: Only the variables from before the innermost if statement have to be restored.
+			if (!m_Ifs.empty() && slot < m_Ifs.back().SlotBase)
+				m_Changes.push_back({ slot, m_Values[slot] });
+
+			m_Values[slot] = value;
+		}
+
+		/////////////////////////////////////////////////////////////////
+		// If statements
+		/////////////////////////////////////////////////////////////////
+		void BeginIf()
+		{
+			m_Ifs.push_back({ static_cast<uint32_t>(m_Values.size()), m_Changes.size(), m_Ends.size() });
+		}
+
+		void BeginBranch()
+		{
+			m_Ifs.back().FirstChange = m_Changes.size();
+		}
+
+		// Note: If the branch continues after the if statement, the final values of the variables it changed are kept.
+		void EndBranch(bool continues)
+		{
+			const If& current = m_Ifs.back();
+
+			if (continues)
+			{
+				m_Ends.push_back(m_EndValues.size());
+
+				m_Epoch++;
+				for (size_t i = current.FirstChange; i < m_Changes.size(); i++)
+				{
+					const uint32_t slot = m_Changes[i].Slot;
+					if (m_Marks[slot] == m_Epoch)
+						continue;
+
+					m_Marks[slot] = m_Epoch;
+					m_EndValues.emplace_back(slot, m_Values[slot]);
+				}
+			}
+
+			for (size_t i = m_Changes.size(); i > current.FirstChange; i--)
+				m_Values[m_Changes[i - 1].Slot] = m_Changes[i - 1].Previous;
+			m_Changes.resize(current.FirstChange);
+		}
+
+		// Note: A path that continues after the if statement without running any branch, like without an else.
+		void AddPath()
+		{
+			m_Ends.push_back(m_EndValues.size());
+		}
+
+		// Returns the amount of paths that continue after the innermost if statement.
+		inline size_t PathCount() const { return m_Ends.size() - m_Ifs.back().FirstEnd; }
+
+		// Joins the paths that continue after the if statement. A variable that was changed by any path
+		// is assigned merge(slot, values), with its value at the end of every path in the order they were
+		// added. Note: The variables keep the values from before the if statement if no path continues.
+		template<typename Merge>
+		void EndIf(Merge&& merge)
+		{
+			const If current = m_Ifs.back();
+			m_Ifs.pop_back();
+
+			const size_t paths = m_Ends.size() - current.FirstEnd;
+			if (paths == 0)
+				return;
+
+			const size_t firstValue = m_Ends[current.FirstEnd];
+			auto getValues = [&](size_t path)
+			{
+				const size_t first = m_Ends[current.FirstEnd + path];
+				const size_t last = (path + 1 < paths ? m_Ends[current.FirstEnd + path + 1] : m_EndValues.size());
+				return std::span<const std::pair<uint32_t, T>>(m_EndValues.data() + first, m_EndValues.data() + last);
+			};
+
+			// Gather the variables that were changed by any path
+			std::vector<uint32_t> slots = { };
+
+			m_Epoch++;
+			for (size_t i = firstValue; i < m_EndValues.size(); i++)
+			{
+				const uint32_t slot = m_EndValues[i].first;
+				if (m_Marks[slot] == m_Epoch)
+					continue;
+
+				m_Marks[slot] = m_Epoch;
+				m_Gathered[slot] = static_cast<uint32_t>(slots.size());
+				slots.push_back(slot);
+			}
+
+			// Note: values[slot * paths + path] is the value of the variable at the end
+			// of a path, the value from before the if statement if it wasn't changed.
+			std::vector<T> values(slots.size() * paths);
+			for (size_t i = 0; i < slots.size(); i++)
+				std::fill_n(values.begin() + i * paths, paths, m_Values[slots[i]]);
+
+			for (size_t i = 0; i < paths; i++)
+			{
+				for (const auto& [slot, value] : getValues(i))
+					values[m_Gathered[slot] * paths + i] = value;
+			}
+
+			m_Ends.resize(current.FirstEnd);
+			m_EndValues.resize(firstValue);
+
+			for (size_t i = 0; i < slots.size(); i++)
+				Assign(slots[i], merge(slots[i], std::span<const T>(values.data() + i * paths, paths)));
+		}
+
+		// Getters
+		inline T& operator [] (uint32_t slot) { return m_Values[slot]; }
+		inline const T& operator [] (uint32_t slot) const { return m_Values[slot]; }
+
+		inline size_t Size() const { return m_Values.size(); }
+
+	private:
+		struct Change
+		{
+		public:
+			uint32_t Slot = 0;
+			T Previous = { };
+		};
+
+		struct If
+		{
+		public:
+			uint32_t SlotBase = 0; // Variables declared before the if statement have a lower slot
+			size_t FirstChange = 0; // Into m_Changes, of the current branch
+			size_t FirstEnd = 0; // Into m_Ends
+		};
+
+	private:
+		std::vector<T> m_Values = { };
+
+		std::vector<Change> m_Changes = { };
+		std::vector<size_t> m_Ends = { }; // The first end value of every path, into m_EndValues
+		std::vector<std::pair<uint32_t, T>> m_EndValues = { };
+		std::vector<If> m_Ifs = { };
+
+		// Note: Used to gather every slot once, a slot is gathered if its mark equals the epoch.
+		std::vector<uint32_t> m_Marks = { };
+		std::vector<uint32_t> m_Gathered = { }; // Slot -> index in the gathered slots
+		uint32_t m_Epoch = 0;
+	};
+
+}
\ No newline at end of file
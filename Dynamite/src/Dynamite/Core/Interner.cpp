@@ -0,0 +1,35 @@
+#include "dypch.h"
+#include "Interner.hpp"
+
+namespace Dynamite
+{
+
+	SymbolId Interner::Intern(std::string_view name)
+	{
+		if (auto it = m_Ids.find(name); it != m_Ids.end())
+			return it->second;
+
+		SymbolId id = static_cast<SymbolId>(m_Names.size());
+		std::string_view stored = m_Storage.emplace_back(name);
+
+		m_Names.push_back(stored);
+		m_Ids.emplace(stored, id);
+		return id;
+	}
+
+	SymbolId Interner::Find(std::string_view name) const
+	{
+		if (auto it = m_Ids.find(name); it != m_Ids.end())
+			return it->second;
+
+		return InvalidSymbol;
+	}
+
+	void Interner::Clear()
+	{
+		m_Ids.clear();
+		m_Names.clear();
+		m_Storage.clear();
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+namespace Dynamite
+{
+
+	// Dense id of an interned string, ids are handed out in order starting at 0.
+	using SymbolId = uint32_t;
+
+	constexpr const SymbolId InvalidSymbol = static_cast<SymbolId>(-1);
+
+	/////////////////////////////////////////////////////////////////
+	// Interner
+	/////////////////////////////////////////////////////////////////
+	// Note: Stores every distinct string once, so names can be
+	// passed around and compared as SymbolId's.
+	class Interner
+	{
+	public:
+		Interner() = default;
+		~Interner() = default;
+
+		// Returns the id of name, adds it if it doesn't exist yet.
+		SymbolId Intern(std::string_view name);
+		// Returns InvalidSymbol if the name hasn't been interned.
+		SymbolId Find(std::string_view name) const;
+
+		// Note: Invalidates all SymbolId's.
+		void Clear();
+
+		// Getters
+		inline std::string_view GetName(SymbolId id) const { return m_Names[id]; }
+		inline size_t Size() const { return m_Names.size(); }
+
+	private:
+		// Note: A deque, so the views into it stay valid.
+		std::deque<std::string> m_Storage = { };
+
+		std::vector<std::string_view> m_Names = { };
+		std::unordered_map<std::string_view, SymbolId> m_Ids = { };
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// SourceLocation
+	/////////////////////////////////////////////////////////////////
+	// Note: Every file loaded by the SourceManager gets its own range
+	// of offsets, so a single 32 bit offset identifies the file, line
+	// and column. Decoding is done lazily by the SourceManager.
+	struct SourceLocation
+	{
+	public:
+		uint32_t Offset = 0;
+
+	public:
+		// Note: Offset 0 is never handed out.
+		inline bool IsValid() const { return Offset != 0; }
+
+		inline bool operator == (const SourceLocation& other) const { return Offset == other.Offset; }
+		inline bool operator != (const SourceLocation& other) const { return Offset != other.Offset; }
+		inline bool operator < (const SourceLocation& other) const { return Offset < other.Offset; }
+	};
+
+}
\ No newline at end of file
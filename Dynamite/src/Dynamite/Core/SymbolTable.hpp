@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Dynamite/Core/Interner.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// Scoped symbol table
+	/////////////////////////////////////////////////////////////////
+	// Note: Maps a SymbolId to its innermost binding. Every binding remembers
+	// the binding it shadows, so the bindings vector doubles as the undo log
+	// and leaving a scope just unwinds it. Since SymbolId's are dense the
+	// table is indexed directly instead of hashed, all operations are O(1).
+	template<typename T>
+	class ScopedSymbolTable
+	{
+	public:
+		ScopedSymbolTable() = default;
+		~ScopedSymbolTable() = default;
+
+		void PushScope()
+		{
+			m_Scopes.push_back(m_Bindings.size());
+		}
+
+		// Removes all bindings that were added since the matching PushScope().
+		void PopScope()
+		{
+			if (m_Scopes.empty())
+				return;
+
+			Pop(m_Bindings.size() - m_Scopes.back());
+			m_Scopes.pop_back();
+		}
+
+		// Note: Shadows any existing binding of symbol, also in the same scope.
+		T& Push(SymbolId symbol, const T& value)
+		{
+			if (symbol >= m_Heads.size())
+				m_Heads.resize(static_cast<size_t>(symbol) + 1, s_NoBinding);
+
+			m_Bindings.emplace_back(symbol, m_Heads[symbol], value);
+			m_Heads[symbol] = static_cast<uint32_t>(m_Bindings.size() - 1);
+
+			return m_Bindings.back().Value;
+		}
+
+		// Removes the last count bindings.
+		void Pop(size_t count)
+		{
+			for (size_t i = 0; i < count && !m_Bindings.empty(); i++)
+			{
+				const Binding& binding = m_Bindings.back();
+				m_Heads[binding.Symbol] = binding.Previous;
+
+				m_Bindings.pop_back();
+			}
+		}
+
+		// Returns the innermost binding of symbol, nullptr if it is not bound.
+		T* Find(SymbolId symbol)
+		{
+			if (symbol >= m_Heads.size() || m_Heads[symbol] == s_NoBinding)
+				return nullptr;
+
+			return &m_Bindings[m_Heads[symbol]].Value;
+		}
+
+		const T* Find(SymbolId symbol) const
+		{
+			return const_cast<ScopedSymbolTable*>(this)->Find(symbol);
+		}
+
+		// Note: Invalidates all bindings and scopes.
+		void Clear()
+		{
+			m_Bindings.clear();
+			m_Heads.clear();
+			m_Scopes.clear();
+		}
+
+		// Getters
+		// Note: Bindings are indexed in the order they were pushed, the
+		// bindings of the current scope are [GetScopeStart(), Size()).
+		inline T& Get(size_t index) { return m_Bindings[index].Value; }
+		inline const T& Get(size_t index) const { return m_Bindings[index].Value; }
+
+		inline size_t GetScopeStart() const { return (m_Scopes.empty() ? 0 : m_Scopes.back()); }
+		inline size_t Size() const { return m_Bindings.size(); }
+		inline size_t ScopeCount() const { return m_Scopes.size(); }
+
+	private:
+		constexpr static const uint32_t s_NoBinding = static_cast<uint32_t>(-1);
+
+		struct Binding
+		{
+		public:
+			SymbolId Symbol = InvalidSymbol;
+			uint32_t Previous = s_NoBinding; // The binding this one shadows
+
+			T Value = { };
+		};
+
+	private:
+		std::vector<Binding> m_Bindings = { };
+		std::vector<uint32_t> m_Heads = { }; // SymbolId -> innermost binding
+		std::vector<size_t> m_Scopes = { };
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "dypch.h"
+#include "ThreadPool.hpp"
+
+namespace Dynamite
+{
+
+	ThreadPool::ThreadPool(size_t threads)
+		: m_Size(threads ? threads : std::max<size_t>(std::thread::hardware_concurrency(), 1))
+	{
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::scoped_lock lock(m_Mutex);
+			m_Stop = true;
+		}
+		m_WorkAvailable.notify_all();
+
+		for (auto& worker : m_Workers)
+			worker.join();
+	}
+
+	void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& func)
+	{
+		if (count == 0)
+			return;
+
+		// Note: Not worth waking up the workers.
+		if (m_Size == 1 || count == 1)
+		{
+			for (size_t i = 0; i < count; i++)
+				func(i);
+			return;
+		}
+
+		if (m_Workers.empty())
+			Start();
+
+		{
+			std::scoped_lock lock(m_Mutex);
+			m_Function = &func;
+			m_Count = count;
+			m_Next = 0;
+			m_Active = m_Workers.size();
+			m_Generation++;
+		}
+		m_WorkAvailable.notify_all();
+
+		RunJobs();
+
+		// Note: We also wait for the workers to leave RunJobs, so the job can be safely replaced.
+		std::unique_lock lock(m_Mutex);
+		m_WorkDone.wait(lock, [this]() { return m_Active == 0; });
+
+		m_Function = nullptr;
+	}
+
+	void ThreadPool::Start()
+	{
+		m_Workers.reserve(m_Size - 1);
+		for (size_t i = 0; i < m_Size - 1; i++)
+			m_Workers.emplace_back([this]() { WorkerLoop(); });
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		uint64_t generation = 0;
+
+		while (true)
+		{
+			{
+				std::unique_lock lock(m_Mutex);
+				m_WorkAvailable.wait(lock, [&]() { return m_Stop || m_Generation != generation; });
+
+				if (m_Stop)
+					return;
+
+				generation = m_Generation;
+			}
+
+			RunJobs();
+
+			{
+				std::scoped_lock lock(m_Mutex);
+				m_Active--;
+			}
+			m_WorkDone.notify_one();
+		}
+	}
+
+	void ThreadPool::RunJobs()
+	{
+		size_t index;
+		while ((index = m_Next.fetch_add(1, std::memory_order_relaxed)) < m_Count)
+			(*m_Function)(index);
+	}
+
+}
\ No newline at end of file
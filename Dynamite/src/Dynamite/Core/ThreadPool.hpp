@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// ThreadPool
+	/////////////////////////////////////////////////////////////////
+	// Note: The worker threads are only created on the first call to
+	// ParallelFor, so a pool that is never used costs nothing.
+	class ThreadPool
+	{
+	public:
+		// Note: 0 uses the amount of hardware threads.
+		ThreadPool(size_t threads = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator = (const ThreadPool&) = delete;
+
+		// Runs func(i) for every i in [0, count) and waits for all of them to finish.
+		// Note: The calling thread also runs jobs, func must be thread safe.
+		void ParallelFor(size_t count, const std::function<void(size_t)>& func);
+
+		// Returns the amount of threads that run jobs (including the calling thread).
+		inline size_t Size() const { return m_Size; }
+
+	private:
+		void Start();
+		void WorkerLoop();
+		void RunJobs();
+
+	private:
+		size_t m_Size = 1;
+		std::vector<std::thread> m_Workers = { };
+
+		std::mutex m_Mutex = {};
+		std::condition_variable m_WorkAvailable = {};
+		std::condition_variable m_WorkDone = {};
+
+		// Current job
+		const std::function<void(size_t)>* m_Function = nullptr;
+		size_t m_Count = 0;
+		std::atomic<size_t> m_Next = 0;
+		uint64_t m_Generation = 0;
+		size_t m_Active = 0;
+
+		bool m_Stop = false;
+	};
+
+}
\ No newline at end of file
@@ -3,126 +3,727 @@
 
 #include "Dynamite/Core/Logging.hpp"
 
+#include <Pulse/Core/Defines.hpp>
 #include <Pulse/Text/Format.hpp>
 
+#include <bit>
+#include <queue>
+
 namespace Dynamite
 {
 
-	void ASMGenerator::Generate(Node::Program& program, const std::filesystem::path& outputPath)
+	namespace
 	{
-		m_OutputPath = outputPath;
-		m_Output.clear();
+		constexpr static const uint32_t s_NoSlot = static_cast<uint32_t>(-1);
 
-		std::filesystem::path dir = outputPath.parent_path();
-		std::filesystem::path result = dir / std::filesystem::path(outputPath.filename()).replace_extension(".asm");
+		// Note: The suffix of scalar SSE instructions.
+		static std::string_view GetFloatSuffix(ValueType type)
+		{
+			return (type == ValueType::Float32 ? "ss" : "sd");
+		}
 
-		std::ofstream output(result);
-		output << GenProgram();
-	}
+		// Returns the setcc condition of an integer comparison.
+		static std::string_view GetCondition(IR::Opcode op, bool isSigned)
+		{
+			switch (op)
+			{
+			case IR::Opcode::Equal:			return "e";
+			case IR::Opcode::NotEqual:		return "ne";
+			case IR::Opcode::Less:			return (isSigned ? "l" : "b");
+			case IR::Opcode::Greater:		return (isSigned ? "g" : "a");
+			case IR::Opcode::LessEqual:		return (isSigned ? "le" : "be");
+			case IR::Opcode::GreaterEqual:	return (isSigned ? "ge" : "ae");
 
-	void ASMGenerator::GenTermExpr(const Node::Reference<Node::TermExpr> term)
-	{
-		struct TermVisitor 
+			default:
+				break;
+			}
+
+			return "";
+		}
+
+		// Note: Dividing by a constant is multiplying by its reciprocal, as a fixed point Multiplier
+		// with the result in the high half of the product shifted right by Shift (Granlund & Montgomery).
+		// With Add the multiplier doesn't fit in 64 bits & the dividend has to be added to the high half.
+		struct Magic
 		{
 		public:
-			ASMGenerator& Generator;
+			uint64_t Multiplier = 0;
+			uint32_t Shift = 0;
+			bool Add = false;
+		};
 
-		public:
-			void operator() (const Node::Reference<Node::LiteralTerm> literalTerm) const
+		// Returns (high * 2^64) / divisor & sets the remainder. Note: high has to be less than divisor.
+		static uint64_t DivideWide(uint64_t high, uint64_t divisor, uint64_t& remainder)
+		{
+			uint64_t quotient = 0;
+			for (uint32_t i = 0; i < 64; i++)
 			{
-				ValueType valueType = GetValueType(static_cast<TokenType>(literalTerm->LiteralType), literalTerm->TokenObj.Value.value());
+				// Note: The bit that's shifted out is part of the remainder, it's always larger than divisor then.
+				const bool carry = ((high >> 63) != 0);
+				high <<= 1;
+				quotient <<= 1;
 
-				switch (literalTerm->LiteralType)
+				if (carry || high >= divisor)
 				{
-				case Node::LiteralTerm::Type::Integer:
+					high -= divisor;
+					quotient |= 1;
+				}
+			}
+
+			remainder = high;
+			return quotient;
+		}
+
+		// Note: For unsigned divisors that aren't a power of 2, the quotient
+		// is (high >> Shift) or (((x - high) >> 1) + high) >> Shift with Add.
+		static Magic GetUnsignedMagic(uint64_t divisor)
+		{
+			const uint32_t log = static_cast<uint32_t>(std::bit_width(divisor) - 1);
+
+			uint64_t remainder = 0;
+			const uint64_t multiplier = DivideWide(1ull << log, divisor, remainder);
+
+			// Note: If 2^(64 + log) is close enough to a multiple of the divisor, the rounded up multiplier is precise enough.
+			if (divisor - remainder < (1ull << log))
+				return { multiplier + 1, log, false };
+
+			// Note: Otherwise it takes 65 bits, of which the top one is implied by Add.
+			const uint64_t twice = remainder + remainder;
+			return { multiplier + multiplier + ((twice >= divisor || twice < remainder) ? 1 : 0) + 1, log, true };
+		}
+
+		// Note: For signed divisors whose absolute value isn't a power of 2, the multiplier has the sign of
+		// the divisor. With Add the dividend is added to the high half, or subtracted for negative divisors.
+		// The quotient is the high half shifted arithmetically by Shift, plus 1 if it's negative.
+		static Magic GetSignedMagic(int64_t divisor)
+		{
+			constexpr const uint64_t high = 1ull << 63;
+			const uint64_t absolute = (divisor < 0 ? 0 - static_cast<uint64_t>(divisor) : static_cast<uint64_t>(divisor));
+			const uint64_t limit = high + (static_cast<uint64_t>(divisor) >> 63);
+			const uint64_t absoluteLimit = limit - 1 - (limit % absolute);
+
+			// Note: Finds the smallest power 2^p for which the multiplier is exact, from Hacker's Delight.
+			uint32_t power = 63;
+			uint64_t q1 = high / absoluteLimit, r1 = high - q1 * absoluteLimit;
+			uint64_t q2 = high / absolute, r2 = high - q2 * absolute;
+			uint64_t delta = 0;
+			do
+			{
+				power++;
+
+				q1 += q1; r1 += r1;
+				if (r1 >= absoluteLimit)
 				{
-					// TODO: ...
-					break;
+					q1++;
+					r1 -= absoluteLimit;
 				}
-				// TODO: Other types
 
-				default:
-					break;
+				q2 += q2; r2 += r2;
+				if (r2 >= absolute)
+				{
+					q2++;
+					r2 -= absolute;
 				}
-			}
-			void operator() (const Node::Reference<Node::IdentifierTerm> identifier) {}
-			void operator() (const Node::Reference<Node::ParenthesisTerm> parenthesis) {}
-		};
 
-		TermVisitor visitor = { .Generator = *this };
-		std::visit(visitor, term->TermObj);
+				delta = absolute - r2;
+			} while (q1 < delta || (q1 == delta && r1 == 0));
+
+			const uint64_t multiplier = (divisor < 0 ? 0 - (q2 + 1) : q2 + 1);
+			const bool add = ((divisor > 0 && static_cast<int64_t>(multiplier) < 0) || (divisor < 0 && static_cast<int64_t>(multiplier) > 0));
+			return { multiplier, power - 64, add };
+		}
 	}
 
-	void ASMGenerator::GenBinaryExpr(const Node::Reference<Node::BinaryExpr> bin_expr)
+	void ASMGenerator::Generate(const IR::Module& module, const std::filesystem::path& outputPath)
 	{
+		m_OutputPath = outputPath;
+		m_Output.str({});
+		m_Data.str({});
+		m_StringCount = 0;
+
+		std::filesystem::path dir = outputPath.parent_path();
+		std::filesystem::path result = dir / std::filesystem::path(outputPath.filename()).replace_extension(".asm");
+
+		std::ofstream output(result);
+		output << GenProgram(module);
 	}
 
-	void ASMGenerator::GenExpr(const Node::Reference<Node::Expression> expr)
+	void ASMGenerator::GenFunction(const IR::Function& function)
 	{
+		m_Function = &function;
+
+		const IR::DominatorTree dominators(function);
+		AllocateSlots(dominators);
+
+		m_Edges.assign(function.BlockCount(), { 0, 0 });
+		for (uint32_t i = 0; i < function.BlockCount(); i++)
+		{
+			const std::vector<IR::Reference<IR::Block>>& predecessors = function.GetBlock({ i }).Predecessors;
+			for (uint32_t j = 0; j < predecessors.size(); j++)
+			{
+				const std::span<const IR::Reference<IR::Block>> successors = function.GetSuccessors(predecessors[j]);
+				m_Edges[predecessors[j].Index][(successors[0].Index == i) ? 0 : 1] = j;
+			}
+		}
+
+		// Note: main is the entry point of the program.
+		m_Output << (function.GetName() == "main" ? std::string("_start") : function.GetName()) << ":\n";
+		m_Output << "    push rbp\n";
+		m_Output << "    mov rbp, rsp\n";
+		if (m_StackSize != 0)
+			m_Output << "    sub rsp, " << m_StackSize << "\n";
+
+		// Note: Unreachable blocks aren't generated.
+		const std::vector<IR::Reference<IR::Block>>& order = dominators.GetOrder();
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			const IR::Reference<IR::Block> next = (i + 1 < order.size() ? order[i + 1] : IR::Reference<IR::Block>());
+
+			m_Output << GetLabel(order[i]) << ":\n";
+			for (const IR::Value value : function.GetBlock(order[i]).Instructions)
+			{
+				if (IR::IsTerminator(function.Get(value).Op))
+					GenTerminator(value, next);
+				else
+					GenInstruction(value);
+			}
+		}
+
+		m_Function = nullptr;
 	}
 
-	void ASMGenerator::GenScope(const Node::Reference<Node::ScopeStatement> scope)
+	void ASMGenerator::GenInstruction(const IR::Value value)
 	{
+		const IR::Instruction& instruction = m_Function->Get(value);
+		const std::span<const IR::Value> operands = m_Function->GetOperands(value);
+
+		switch (instruction.Op)
+		{
+		case IR::Opcode::Constant:
+		{
+			if (instruction.Type == ValueType::String)
+			{
+				const std::string label = Pulse::Text::Format("_Dynamite_String_{0}", m_StringCount++);
+
+				m_Data << label << ": db ";
+				for (const char c : instruction.Constant.String)
+					m_Data << static_cast<uint32_t>(static_cast<uint8_t>(c)) << ", ";
+				m_Data << "0\n";
+
+				m_Output << "    lea rax, [rel " << label << "]\n";
+				Store(value);
+				return;
+			}
+
+			// Note: Immediates are sign extended from 32 bits.
+			const uint64_t bits = GetConstantBits(instruction.Constant);
+			if (static_cast<int64_t>(bits) >= Pulse::Numeric::Min<int32_t>() && static_cast<int64_t>(bits) <= Pulse::Numeric::Max<int32_t>())
+				m_Output << "    mov QWORD " << GetSlot(value) << ", " << static_cast<int64_t>(bits) << "\n";
+			else
+			{
+				m_Output << "    mov rax, " << bits << "\n";
+				m_Output << "    mov " << GetSlot(value) << ", rax\n";
+			}
+			return;
+		}
+		case IR::Opcode::Cast:
+		{
+			GenCast(value);
+			return;
+		}
+		case IR::Opcode::Phi: // Note: Phis are set by the predecessors of their block.
+			return;
+
+		default:
+			break;
+		}
+
+		if (!IR::IsBinary(instruction.Op))
+			return;
+
+		const ValueType type = m_Function->GetType(operands[0]);
+		const bool bitwise = (instruction.Op == IR::Opcode::Or || instruction.Op == IR::Opcode::And || instruction.Op == IR::Opcode::Xor);
+
+		/////////////////////////////////////////////////////////////////
+		// Floats
+		/////////////////////////////////////////////////////////////////
+		// Note: Bitwise operators work on the bits of floats, like on integers.
+		if (ValueTypeIsFloat(type) && !bitwise)
+		{
+			const std::string_view suffix = GetFloatSuffix(type);
+			Load(operands[0], 0);
+			Load(operands[1], 1);
+
+			switch (instruction.Op)
+			{
+			case IR::Opcode::Add:	m_Output << "    add" << suffix << " xmm0, xmm1\n"; break;
+			case IR::Opcode::Sub:	m_Output << "    sub" << suffix << " xmm0, xmm1\n"; break;
+			case IR::Opcode::Mul:	m_Output << "    mul" << suffix << " xmm0, xmm1\n"; break;
+			case IR::Opcode::Div:	m_Output << "    div" << suffix << " xmm0, xmm1\n"; break;
+
+			// Note: Comparisons with NaN are false, only != is true.
+			case IR::Opcode::Equal:
+				m_Output << "    ucomi" << suffix << " xmm0, xmm1\n";
+				m_Output << "    sete al\n";
+				m_Output << "    setnp cl\n";
+				m_Output << "    and al, cl\n";
+				break;
+			case IR::Opcode::NotEqual:
+				m_Output << "    ucomi" << suffix << " xmm0, xmm1\n";
+				m_Output << "    setne al\n";
+				m_Output << "    setp cl\n";
+				m_Output << "    or al, cl\n";
+				break;
+			case IR::Opcode::Less:			m_Output << "    ucomi" << suffix << " xmm1, xmm0\n    seta al\n"; break;
+			case IR::Opcode::Greater:		m_Output << "    ucomi" << suffix << " xmm0, xmm1\n    seta al\n"; break;
+			case IR::Opcode::LessEqual:		m_Output << "    ucomi" << suffix << " xmm1, xmm0\n    setae al\n"; break;
+			case IR::Opcode::GreaterEqual:	m_Output << "    ucomi" << suffix << " xmm0, xmm1\n    setae al\n"; break;
+
+			default:
+				break;
+			}
+
+			if (IR::IsComparison(instruction.Op))
+				m_Output << "    movzx eax, al\n";
+
+			Store(value);
+			return;
+		}
+
+		/////////////////////////////////////////////////////////////////
+		// Integers
+		/////////////////////////////////////////////////////////////////
+		// Note: Both operands are extended to 64 bits, so the 64 bit instructions give the right
+		// result after extending it again. Which is also how the result wraps around.
+		auto isConstant = [this](IR::Value operand) { return m_Function->Get(operand).Op == IR::Opcode::Constant; };
+
+		// Note: Multiplications are commutative, so the constant can be either operand.
+		const bool swap = (instruction.Op == IR::Opcode::Mul && isConstant(operands[0]) && !isConstant(operands[1]));
+		const IR::Value lhs = operands[swap ? 1 : 0];
+		const IR::Value rhs = operands[swap ? 0 : 1];
+
+		m_Output << "    mov rax, " << GetSlot(lhs) << "\n";
+		if (isConstant(rhs))
+		{
+			const uint64_t constant = GetConstantBits(m_Function->Get(rhs).Constant);
+			if ((instruction.Op == IR::Opcode::Mul && GenMultiply(constant)) || (instruction.Op == IR::Opcode::Div && GenDivide(type, constant)))
+			{
+				Extend(instruction.Type);
+				m_Output << "    mov " << GetSlot(value) << ", rax\n";
+				return;
+			}
+		}
+
+		m_Output << "    mov rcx, " << GetSlot(rhs) << "\n";
+
+		if (IR::IsComparison(instruction.Op))
+		{
+			m_Output << "    cmp rax, rcx\n";
+			m_Output << "    set" << GetCondition(instruction.Op, ValueTypeIsSigned(type)) << " al\n";
+			m_Output << "    movzx eax, al\n";
+
+			Store(value);
+			return;
+		}
+
+		switch (instruction.Op)
+		{
+		case IR::Opcode::Add:	m_Output << "    add rax, rcx\n"; break;
+		case IR::Opcode::Sub:	m_Output << "    sub rax, rcx\n"; break;
+		case IR::Opcode::Mul:	m_Output << "    imul rax, rcx\n"; break;
+		case IR::Opcode::Div:
+		{
+			if (ValueTypeIsSigned(type))
+				m_Output << "    cqo\n    idiv rcx\n";
+			else
+				m_Output << "    xor edx, edx\n    div rcx\n";
+			break;
+		}
+		case IR::Opcode::Or:	m_Output << "    or rax, rcx\n"; break;
+		case IR::Opcode::And:	m_Output << "    and rax, rcx\n"; break;
+		case IR::Opcode::Xor:	m_Output << "    xor rax, rcx\n"; break;
+
+		default:
+			break;
+		}
+
+		Extend(instruction.Type);
+		m_Output << "    mov " << GetSlot(value) << ", rax\n";
+	}
+
+	void ASMGenerator::GenCast(const IR::Value value)
+	{
+		const IR::Instruction& instruction = m_Function->Get(value);
+		const ValueType to = instruction.Type;
+		const ValueType from = m_Function->GetType(instruction.Operands[0]);
+
+		Load(instruction.Operands[0], 0);
+
+		if (to == ValueType::Bool)
+		{
+			if (ValueTypeIsFloat(from))
+			{
+				// Note: NaN is true.
+				m_Output << "    xorps xmm1, xmm1\n";
+				m_Output << "    ucomi" << GetFloatSuffix(from) << " xmm0, xmm1\n";
+				m_Output << "    setne al\n";
+				m_Output << "    setp cl\n";
+				m_Output << "    or al, cl\n";
+				m_Output << "    movzx eax, al\n";
+			}
+			else
+				Extend(ValueType::Bool);
+		}
+		else if (ValueTypeIsFloat(to) && ValueTypeIsFloat(from))
+		{
+			m_Output << "    cvt" << GetFloatSuffix(from) << "2" << GetFloatSuffix(to) << " xmm0, xmm0\n";
+		}
+		else if (ValueTypeIsFloat(to))
+		{
+			const std::string_view suffix = GetFloatSuffix(to);
+			if (from != ValueType::UInt64)
+				m_Output << "    cvtsi2" << suffix << " xmm0, rax\n";
+			else
+			{
+				// Note: Values with the top bit set are halved (keeping the lowest
+				// bit for rounding), converted as signed and doubled again.
+				const std::string large = CreateLabel();
+				const std::string done = CreateLabel();
+
+				m_Output << "    test rax, rax\n";
+				m_Output << "    js " << large << "\n";
+				m_Output << "    cvtsi2" << suffix << " xmm0, rax\n";
+				m_Output << "    jmp " << done << "\n";
+				m_Output << large << ":\n";
+				m_Output << "    mov rcx, rax\n";
+				m_Output << "    shr rcx, 1\n";
+				m_Output << "    and eax, 1\n";
+				m_Output << "    or rcx, rax\n";
+				m_Output << "    cvtsi2" << suffix << " xmm0, rcx\n";
+				m_Output << "    add" << suffix << " xmm0, xmm0\n";
+				m_Output << done << ":\n";
+			}
+		}
+		else if (ValueTypeIsFloat(from))
+		{
+			// Note: Truncates like C, out of range values are undefined.
+			m_Output << "    cvtt" << GetFloatSuffix(from) << "2si rax, xmm0\n";
+			Extend(to);
+		}
+		else if (from == ValueType::Bool)
+		{
+			// Note: Bools are 0 or 1, so zero extending gives the same number in every integer type.
+			m_Output << "    movzx eax, al\n";
+		}
+		else
+			Extend(to);
+
+		Store(value);
 	}
 
-	void ASMGenerator::GenConditionBranch(const Node::Reference<Node::ConditionBranch> branch, const std::string& endLabel)
+	bool ASMGenerator::GenMultiply(uint64_t multiplier)
 	{
+		if (multiplier == 0)
+		{
+			m_Output << "    xor eax, eax\n";
+			return true;
+		}
+
+		// Note: The multiplier is an odd factor times 2^shift, negative multipliers are negated afterwards.
+		const bool negative = (static_cast<int64_t>(multiplier) < 0);
+		const uint64_t absolute = (negative ? 0 - multiplier : multiplier);
+		const uint32_t shift = static_cast<uint32_t>(std::countr_zero(absolute));
+		const uint64_t odd = absolute >> shift;
+
+		if (!negative && (odd == 3 || odd == 5 || odd == 9))
+		{
+			m_Output << "    lea rax, [rax + rax * " << (odd - 1) << "]\n";
+		}
+		else if (!negative && odd != 1 && (std::has_single_bit(odd - 1) || std::has_single_bit(odd + 1)))
+		{
+			// Note: x * (2^n + 1) = (x << n) + x & x * (2^n - 1) = (x << n) - x.
+			const bool add = std::has_single_bit(odd - 1);
+			m_Output << "    mov rcx, rax\n";
+			m_Output << "    shl rax, " << std::countr_zero(add ? odd - 1 : odd + 1) << "\n";
+			m_Output << "    " << (add ? "add" : "sub") << " rax, rcx\n";
+		}
+		else if (odd != 1)
+		{
+			// Note: Immediates are sign extended from 32 bits.
+			if (static_cast<int64_t>(multiplier) < Pulse::Numeric::Min<int32_t>() || static_cast<int64_t>(multiplier) > Pulse::Numeric::Max<int32_t>())
+				return false;
+
+			m_Output << "    imul rax, rax, " << static_cast<int64_t>(multiplier) << "\n";
+			return true;
+		}
+
+		if (shift != 0)
+			m_Output << "    shl rax, " << shift << "\n";
+		if (negative)
+			m_Output << "    neg rax\n";
+
+		return true;
 	}
 
-	void ASMGenerator::GenStatement(const Node::Reference<Node::Statement> statement)
+	bool ASMGenerator::GenDivide(ValueType type, uint64_t divisor)
 	{
+		// Note: Dividing by 0 traps, which is left to happen at runtime.
+		if (divisor == 0)
+			return false;
+
+		/////////////////////////////////////////////////////////////////
+		// Unsigned
+		/////////////////////////////////////////////////////////////////
+		if (!ValueTypeIsSigned(type))
+		{
+			if (std::has_single_bit(divisor))
+			{
+				if (divisor != 1)
+					m_Output << "    shr rax, " << std::countr_zero(divisor) << "\n";
+				return true;
+			}
+
+			// Note: Divisors with the top bit set fit in the dividend at most once.
+			if (static_cast<int64_t>(divisor) < 0)
+			{
+				m_Output << "    mov rcx, " << divisor << "\n";
+				m_Output << "    cmp rax, rcx\n";
+				m_Output << "    setae al\n";
+				m_Output << "    movzx eax, al\n";
+				return true;
+			}
+
+			const Magic magic = GetUnsignedMagic(divisor);
+			if (magic.Add)
+				m_Output << "    mov rcx, rax\n";
+
+			m_Output << "    mov rdx, " << magic.Multiplier << "\n";
+			m_Output << "    mul rdx\n";
+
+			if (magic.Add)
+			{
+				m_Output << "    sub rcx, rdx\n";
+				m_Output << "    shr rcx, 1\n";
+				m_Output << "    add rdx, rcx\n";
+			}
+
+			m_Output << "    mov rax, rdx\n";
+			if (magic.Shift != 0)
+				m_Output << "    shr rax, " << magic.Shift << "\n";
+
+			return true;
+		}
+
+		/////////////////////////////////////////////////////////////////
+		// Signed
+		/////////////////////////////////////////////////////////////////
+		const int64_t signedDivisor = static_cast<int64_t>(divisor);
+		if (signedDivisor == -1)
+		{
+			// Note: The smallest i64 divided by -1 traps, smaller types are divided as 64 bits so they can't.
+			if (type == ValueType::Int64)
+				return false;
+
+			m_Output << "    neg rax\n";
+			return true;
+		}
+
+		const uint64_t absolute = (signedDivisor < 0 ? 0 - divisor : divisor);
+		if (std::has_single_bit(absolute))
+		{
+			// Note: Shifting rounds down, negative dividends are rounded towards 0 by adding 2^n - 1 first.
+			const uint32_t shift = static_cast<uint32_t>(std::countr_zero(absolute));
+			if (shift != 0)
+			{
+				m_Output << "    mov rcx, rax\n";
+				m_Output << "    sar rcx, 63\n";
+				m_Output << "    shr rcx, " << (64 - shift) << "\n";
+				m_Output << "    add rax, rcx\n";
+				m_Output << "    sar rax, " << shift << "\n";
+			}
+
+			if (signedDivisor < 0)
+				m_Output << "    neg rax\n";
+
+			return true;
+		}
+
+		const Magic magic = GetSignedMagic(signedDivisor);
+		if (magic.Add)
+			m_Output << "    mov rcx, rax\n";
+
+		m_Output << "    mov rdx, " << magic.Multiplier << "\n";
+		m_Output << "    imul rdx\n";
+
+		if (magic.Add)
+			m_Output << "    " << (signedDivisor > 0 ? "add" : "sub") << " rdx, rcx\n";
+		if (magic.Shift != 0)
+			m_Output << "    sar rdx, " << magic.Shift << "\n";
+
+		// Note: The high half is rounded down, adding the sign bit rounds negative quotients towards 0.
+		m_Output << "    mov rax, rdx\n";
+		m_Output << "    shr rax, 63\n";
+		m_Output << "    add rax, rdx\n";
+		return true;
 	}
 
-	std::string ASMGenerator::GenProgram()
+	void ASMGenerator::GenTerminator(const IR::Value value, const IR::Reference<IR::Block> next)
 	{
-		Node::Program program = {};
+		const IR::Instruction& instruction = m_Function->Get(value);
+		switch (instruction.Op)
+		{
+		case IR::Opcode::Jump:
+		{
+			GenPhiCopies(instruction.Parent, instruction.Targets[0]);
+			if (instruction.Targets[0] != next)
+				m_Output << "    jmp " << GetLabel(instruction.Targets[0]) << "\n";
+			break;
+		}
+		case IR::Opcode::Branch:
+		{
+			const IR::Reference<IR::Block> onTrue = instruction.Targets[0];
+			const IR::Reference<IR::Block> onFalse = instruction.Targets[1];
 
-		m_Output << "global _start\n";
-		m_Output << "_start:\n";
+			auto hasPhis = [this](IR::Reference<IR::Block> block)
+			{
+				const std::vector<IR::Value>& instructions = m_Function->GetBlock(block).Instructions;
+				return (!instructions.empty() && m_Function->Get(instructions[0]).Op == IR::Opcode::Phi);
+			};
 
-		for (const auto& statement : program.Statements)
-			GenStatement(statement);
+			m_Output << "    mov rax, " << GetSlot(instruction.Operands[0]) << "\n";
+			m_Output << "    test rax, rax\n";
 
-		// 60 is the syscall for exit on linux.
-		// Default exit code of 0
-		m_Output << "    mov rax, 60\n";
-		m_Output << "    mov rdi, 0\n";
-		m_Output << "    syscall\n";
+			// Note: The phis of a target are only set on the way to that target.
+			if (hasPhis(onTrue) || hasPhis(onFalse))
+			{
+				const std::string label = CreateLabel();
+				m_Output << "    jz " << label << "\n";
+				GenPhiCopies(instruction.Parent, onTrue);
+				m_Output << "    jmp " << GetLabel(onTrue) << "\n";
 
-		return m_Output.str();
+				m_Output << label << ":\n";
+				GenPhiCopies(instruction.Parent, onFalse);
+				if (onFalse != next)
+					m_Output << "    jmp " << GetLabel(onFalse) << "\n";
+			}
+			else if (onTrue == next)
+				m_Output << "    jz " << GetLabel(onFalse) << "\n";
+			else
+			{
+				m_Output << "    jnz " << GetLabel(onTrue) << "\n";
+				if (onFalse != next)
+					m_Output << "    jmp " << GetLabel(onFalse) << "\n";
+			}
+			break;
+		}
+		case IR::Opcode::Exit:
+		{
+			// 60 is the syscall for exit on linux.
+			m_Output << "    mov rdi, " << GetSlot(instruction.Operands[0]) << "\n";
+			m_Output << "    mov rax, 60\n";
+			m_Output << "    syscall\n";
+			break;
+		}
+
+		default:
+			break;
+		}
 	}
 
-	void ASMGenerator::Push(ValueType type, const std::string& reg)
+	void ASMGenerator::GenPhiCopies(const IR::Reference<IR::Block> block, const IR::Reference<IR::Block> target)
 	{
+		const IR::Block& targetBlock = m_Function->GetBlock(target);
+
+		size_t count = 0;
+		while (count < targetBlock.Instructions.size() && m_Function->Get(targetBlock.Instructions[count]).Op == IR::Opcode::Phi)
+			count++;
+
+		if (count == 0)
+			return;
+
+		const size_t index = m_Edges[block.Index][(m_Function->GetSuccessors(block)[0] == target) ? 0 : 1];
+
+		if (count == 1)
+		{
+			m_Output << "    mov rax, " << GetSlot(m_Function->GetOperands(targetBlock.Instructions[0])[index]) << "\n";
+			m_Output << "    mov " << GetSlot(targetBlock.Instructions[0]) << ", rax\n";
+			return;
+		}
+
+		// Note: All phis are set at once, so a phi can be the operand of another phi.
+		for (size_t i = 0; i < count; i++)
+			Push(m_Function->GetOperands(targetBlock.Instructions[i])[index]);
+		for (size_t i = count; i > 0; i--)
+			Pop(targetBlock.Instructions[i - 1]);
 	}
 
-	void ASMGenerator::Pop(ValueType type, const std::string& reg)
+	std::string ASMGenerator::GenProgram(const IR::Module& module)
 	{
+		m_Output << "global _start\n";
+		m_Output << "section .text\n";
+
+		for (const IR::Function& function : module.Functions)
+			GenFunction(function);
+
+		if (m_StringCount != 0)
+		{
+			m_Output << "section .rodata\n";
+			m_Output << m_Data.str();
+		}
+
+		return m_Output.str();
 	}
 
-	void ASMGenerator::BeginScope()
+	void ASMGenerator::Load(const IR::Value value, size_t operand)
 	{
-		m_Scopes.push_back(m_Variables.size());
+		const ValueType type = m_Function->GetType(value);
+		if (ValueTypeIsFloat(type))
+			m_Output << "    mov" << GetFloatSuffix(type) << " xmm" << operand << ", " << GetSlot(value) << "\n";
+		else
+			m_Output << "    mov " << (operand == 0 ? "rax" : "rcx") << ", " << GetSlot(value) << "\n";
 	}
 
-	void ASMGenerator::EndScope()
+	void ASMGenerator::Store(const IR::Value value)
 	{
-		const size_t popCount = m_Variables.size() - m_Scopes.back();
-		size_t removeSize = 0;
+		const ValueType type = m_Function->GetType(value);
+		if (ValueTypeIsFloat(type))
+			m_Output << "    mov" << GetFloatSuffix(type) << " " << GetSlot(value) << ", xmm0\n";
+		else
+			m_Output << "    mov " << GetSlot(value) << ", rax\n";
+	}
 
-		if (popCount != 0)
+	void ASMGenerator::Extend(ValueType type)
+	{
+		switch (type)
 		{
-			for (size_t i = (m_Variables.size() - 1); i > ((m_Variables.size() - 1) - popCount); i--)
-				removeSize += ValueTypeSize(m_Variables[i].Type);
+		case ValueType::Bool:
+			m_Output << "    test rax, rax\n";
+			m_Output << "    setne al\n";
+			m_Output << "    movzx eax, al\n";
+			break;
+
+		case ValueType::Int8:
+		case ValueType::Char:	m_Output << "    movsx rax, al\n"; break;
+		case ValueType::Int16:	m_Output << "    movsx rax, ax\n"; break;
+		case ValueType::Int32:	m_Output << "    movsxd rax, eax\n"; break;
 
-			m_Output << "\tadd rsp, " << removeSize << "\n";
+		case ValueType::UInt8:	m_Output << "    movzx eax, al\n"; break;
+		case ValueType::UInt16:	m_Output << "    movzx eax, ax\n"; break;
+		case ValueType::UInt32:	m_Output << "    mov eax, eax\n"; break;
+
+		default:
+			break;
 		}
-		
-		m_StackSize -= removeSize;
-		for (size_t i = 0; i < popCount; i++)
-			m_Variables.pop_back();
+	}
+
+	void ASMGenerator::Push(const IR::Value value)
+	{
+		m_Output << "    push QWORD " << GetSlot(value) << "\n";
+	}
 
-		m_Scopes.pop_back();
+	void ASMGenerator::Pop(const IR::Value value)
+	{
+		m_Output << "    pop QWORD " << GetSlot(value) << "\n";
 	}
 
 	std::string ASMGenerator::CreateLabel()
@@ -130,4 +731,104 @@ namespace Dynamite
 		return Pulse::Text::Format("_Dynamite_Label_{0}", m_LabelCount++);
 	}
 
+	std::string ASMGenerator::GetLabel(const IR::Reference<IR::Block> block) const
+	{
+		return Pulse::Text::Format("_Dynamite_{0}_Block_{1}", m_Function->GetName(), block.Index);
+	}
+
+	std::string ASMGenerator::GetSlot(const IR::Value value) const
+	{
+		return Pulse::Text::Format("[rbp - {0}]", (static_cast<size_t>(m_Slots[value.Index]) + 1) * 8);
+	}
+
+	void ASMGenerator::AllocateSlots(const IR::DominatorTree& dominators)
+	{
+		const IR::Function& function = *m_Function;
+		const std::vector<IR::Reference<IR::Block>>& order = dominators.GetOrder();
+
+		// Note: The position of every instruction in the order they're generated in,
+		// the operands of a phi are used at the end of their predecessor.
+		std::vector<uint32_t> positions(function.InstructionCount(), 0);
+		std::vector<uint32_t> blockEnds(function.BlockCount(), 0);
+
+		uint32_t position = 0;
+		for (const IR::Reference<IR::Block> block : order)
+		{
+			for (const IR::Value value : function.GetBlock(block).Instructions)
+				positions[value.Index] = position++;
+
+			blockEnds[block.Index] = position - 1;
+		}
+
+		// Note: A value is alive in [starts[value], ends[value]], phis are alive from their first predecessor.
+		std::vector<uint32_t> starts(function.InstructionCount(), s_NoSlot);
+		std::vector<uint32_t> ends(function.InstructionCount(), 0);
+		std::vector<IR::Value> values = { };
+
+		for (const IR::Reference<IR::Block> block : order)
+		{
+			const std::vector<IR::Reference<IR::Block>>& predecessors = function.GetBlock(block).Predecessors;
+			for (const IR::Value value : function.GetBlock(block).Instructions)
+			{
+				const IR::Instruction& instruction = function.Get(value);
+				if (instruction.Type != ValueType::None)
+				{
+					starts[value.Index] = std::min(starts[value.Index], positions[value.Index]);
+					ends[value.Index] = std::max(ends[value.Index], positions[value.Index]);
+					values.push_back(value);
+				}
+
+				const std::span<const IR::Value> operands = function.GetOperands(value);
+				for (size_t i = 0; i < operands.size(); i++)
+				{
+					if (instruction.Op != IR::Opcode::Phi)
+					{
+						ends[operands[i].Index] = std::max(ends[operands[i].Index], positions[value.Index]);
+						continue;
+					}
+
+					if (!dominators.IsReachable(predecessors[i]))
+						continue;
+
+					const uint32_t use = blockEnds[predecessors[i].Index];
+					ends[operands[i].Index] = std::max(ends[operands[i].Index], use);
+					starts[value.Index] = std::min(starts[value.Index], use);
+				}
+			}
+		}
+
+		std::stable_sort(values.begin(), values.end(), [&starts](IR::Value a, IR::Value b) { return starts[a.Index] < starts[b.Index]; });
+
+		// Note: A slot is free again after the last use of its value.
+		using Active = std::pair<uint32_t, uint32_t>; // The end & slot
+		std::priority_queue<Active, std::vector<Active>, std::greater<Active>> active = { };
+		std::vector<uint32_t> free = { };
+		uint32_t slots = 0;
+
+		m_Slots.assign(function.InstructionCount(), s_NoSlot);
+		for (const IR::Value value : values)
+		{
+			while (!active.empty() && active.top().first < starts[value.Index])
+			{
+				free.push_back(active.top().second);
+				active.pop();
+			}
+
+			uint32_t slot = slots;
+			if (free.empty())
+				slots++;
+			else
+			{
+				slot = free.back();
+				free.pop_back();
+			}
+
+			m_Slots[value.Index] = slot;
+			active.push({ ends[value.Index], slot });
+		}
+
+		// Note: The stack stays 16 byte aligned.
+		m_StackSize = ((static_cast<size_t>(slots) * 8) + 15) & ~static_cast<size_t>(15);
+	}
+
 }
\ No newline at end of file
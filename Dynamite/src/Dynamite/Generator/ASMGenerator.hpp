@@ -1,27 +1,26 @@
 #pragma once
 
-#include "Dynamite/Tokens/Token.hpp"
-
-#include "Dynamite/Parsing/Nodes.hpp"
 #include "Dynamite/Parsing/Variables.hpp"
 
+#include "Dynamite/IR/IR.hpp"
+#include "Dynamite/IR/Dominators.hpp"
+
 #include "Dynamite/Generator/Generator.hpp"
 
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sstream>
 #include <filesystem>
 
 namespace Dynamite
 {
 
-	struct ASMVariable
-	{
-	public:
-		std::string Name = {};
-		ValueType Type = ValueType::None;
-
-		size_t StackLocation = 0;
-	};
-
 	// Note: We use the linux calling convention.
+	// Every value lives in a stack slot of 8 bytes, in which integers are sign or zero
+	// extended to 64 bits, bools are 0 or 1 and floats are stored in the low bytes.
+	// Values that aren't alive at the same time share a slot.
 	class ASMGenerator : public Generator
 	{
 	public:
@@ -29,37 +28,56 @@ namespace Dynamite
 		virtual ~ASMGenerator() = default;
 
 		// Note: The extension of the outputPath is irrelevant
-		void Generate(Node::Program& program, const std::filesystem::path& outputPath) override;
+		void Generate(const IR::Module& module, const std::filesystem::path& outputPath) override;
 
 	public:
-		void GenTermExpr(const Node::Reference<Node::TermExpr> term);
-		void GenBinaryExpr(const Node::Reference<Node::BinaryExpr> bin_expr);
-		void GenExpr(const Node::Reference<Node::Expression> expr);
-
-		void GenScope(const Node::Reference<Node::ScopeStatement> scope);
-		void GenConditionBranch(const Node::Reference<Node::ConditionBranch> branch, const std::string& endLabel);
-		void GenStatement(const Node::Reference<Node::Statement> statement);
-
-		[[nodiscard]] std::string GenProgram();
-
-		void Push(ValueType type, const std::string& reg);
-		void Pop(ValueType type, const std::string& reg);
-
-		void BeginScope();
-		void EndScope();
+		void GenFunction(const IR::Function& function);
+		void GenInstruction(const IR::Value value);
+		void GenCast(const IR::Value value);
+		// Note: Multiply or divide rax by a constant without loading it, with shifts or a multiply by its
+		// reciprocal instead of a division. Returns false (without output) if the instruction is needed.
+		bool GenMultiply(uint64_t multiplier);
+		bool GenDivide(ValueType type, uint64_t divisor);
+		// Note: Falls through to next if it's a target.
+		void GenTerminator(const IR::Value value, const IR::Reference<IR::Block> next);
+		// Sets the phis of target to their operands that come from block.
+		void GenPhiCopies(const IR::Reference<IR::Block> block, const IR::Reference<IR::Block> target);
+
+		[[nodiscard]] std::string GenProgram(const IR::Module& module);
+
+		// Note: Operand 0 & the result use rax or xmm0, operand 1 uses rcx or xmm1.
+		void Load(const IR::Value value, size_t operand = 0);
+		void Store(const IR::Value value);
+		// Sign or zero extends the result in rax to 64 bits.
+		void Extend(ValueType type);
+
+		void Push(const IR::Value value);
+		void Pop(const IR::Value value);
 
 		std::string CreateLabel();
+		std::string GetLabel(const IR::Reference<IR::Block> block) const;
+		std::string GetSlot(const IR::Value value) const;
+
+	private:
+		// Note: The values are alive from their definition up to their last use in the
+		// reverse postorder, since the graph has no cycles that covers every path.
+		void AllocateSlots(const IR::DominatorTree& dominators);
 
 	private:
 		std::stringstream m_Output = {};
+		std::stringstream m_Data = {};
 		std::filesystem::path m_OutputPath = {};
 
+		// Note: Only set while generating.
+		const IR::Function* m_Function = nullptr;
+
+		std::vector<uint32_t> m_Slots = { }; // Value -> slot
+		// Note: The index of a block in the predecessors of its successors, so phi operands are found in O(1).
+		std::vector<std::array<uint32_t, 2>> m_Edges = { }; // Block -> index per successor
 		size_t m_StackSize = 0;
 
-		std::vector<ASMVariable> m_Variables = { };
-		std::vector<size_t> m_Scopes = { 0 };
-		
 		size_t m_LabelCount = 0;
+		size_t m_StringCount = 0;
 	};
 
 }
\ No newline at end of file
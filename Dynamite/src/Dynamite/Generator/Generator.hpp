@@ -1,9 +1,6 @@
 #pragma once
 
-#include "Dynamite/Tokens/Token.hpp"
-
-#include "Dynamite/Parsing/Nodes.hpp"
-#include "Dynamite/Parsing/Variables.hpp"
+#include "Dynamite/IR/IR.hpp"
 
 #include <Pulse/Core/Unique.hpp>
 
@@ -21,7 +18,7 @@ namespace Dynamite
 		virtual ~Generator() = default;
 	
 		// Note: The extension of the outputPath is irrelevant
-		virtual void Generate(Node::Program& program, const std::filesystem::path& outputPath) = 0;
+		virtual void Generate(const IR::Module& module, const std::filesystem::path& outputPath) = 0;
 
 		static Pulse::Unique<Generator> Create(Type type = Type::ASM);
 	};
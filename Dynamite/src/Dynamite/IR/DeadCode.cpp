@@ -0,0 +1,82 @@
+#include "dypch.h"
+#include "DeadCode.hpp"
+
+namespace Dynamite::IR
+{
+
+	namespace
+	{
+		// Note: Integer division traps when dividing by 0 (or the smallest i64 by -1, smaller types
+		// are divided as 64 bits), which has to happen at runtime even if the result is never used.
+		static bool CanTrap(const Function& function, const Instruction& instruction)
+		{
+			if (instruction.Op != Opcode::Div || ValueTypeIsFloat(instruction.Type))
+				return false;
+
+			const Instruction& divisor = function.Get(instruction.Operands[1]);
+			if (divisor.Op != Opcode::Constant)
+				return true;
+
+			const uint64_t bits = GetConstantBits(divisor.Constant);
+			return (bits == 0 || (instruction.Type == ValueType::Int64 && static_cast<int64_t>(bits) == -1));
+		}
+	}
+
+	size_t RemoveDeadCode(Function& function)
+	{
+		// Note: Marks the values that are used, starting at the instructions that have to run.
+		std::vector<bool> used(function.InstructionCount(), false);
+		std::vector<Value> worklist = { };
+
+		for (uint32_t i = 0; i < function.BlockCount(); i++)
+		{
+			for (const Value value : function.GetBlock({ i }).Instructions)
+			{
+				const Instruction& instruction = function.Get(value);
+				if (IsTerminator(instruction.Op) || CanTrap(function, instruction))
+				{
+					used[value.Index] = true;
+					worklist.push_back(value);
+				}
+			}
+		}
+
+		while (!worklist.empty())
+		{
+			const Value value = worklist.back();
+			worklist.pop_back();
+
+			for (const Value operand : function.GetOperands(value))
+			{
+				if (used[operand.Index])
+					continue;
+
+				used[operand.Index] = true;
+				worklist.push_back(operand);
+			}
+		}
+
+		std::vector<Value> dead = { };
+		for (uint32_t i = 0; i < function.BlockCount(); i++)
+		{
+			for (const Value value : function.GetBlock({ i }).Instructions)
+			{
+				if (!used[value.Index])
+					dead.push_back(value);
+			}
+		}
+
+		function.Remove(dead);
+		return dead.size();
+	}
+
+	size_t RemoveDeadCode(Module& module)
+	{
+		size_t removed = 0;
+		for (Function& function : module.Functions)
+			removed += RemoveDeadCode(function);
+
+		return removed;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Dynamite/IR/IR.hpp"
+
+#include <cstddef>
+
+namespace Dynamite::IR
+{
+
+	// Removes the instructions whose value is never used, like the stores to & the variables
+	// that are never read (a variable is just the values assigned to it). Terminators are kept &
+	// so are divisions that could trap, everything else has no side effects.
+	// Returns the amount of instructions that were removed.
+	size_t RemoveDeadCode(Function& function);
+	size_t RemoveDeadCode(Module& module);
+
+}
\ No newline at end of file
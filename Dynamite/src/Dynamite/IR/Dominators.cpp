@@ -0,0 +1,192 @@
+#include "dypch.h"
+#include "Dominators.hpp"
+
+namespace Dynamite::IR
+{
+
+	DominatorTree::DominatorTree(const Function& function)
+	{
+		const size_t count = function.BlockCount();
+		m_Order.assign(count, s_Unreachable);
+		m_ChildOffsets.assign(count + 1, 0);
+		m_Enter.assign(count, 0);
+		m_Exit.assign(count, 0);
+
+		if (count == 0)
+			return;
+
+		/////////////////////////////////////////////////////////////////
+		// Depth first search
+		/////////////////////////////////////////////////////////////////
+		// Note: The blocks are walked with an explicit stack, so long chains of blocks can't overflow the stack.
+		// Successors are walked last to first, so the first successor comes first in the reverse postorder.
+		struct Work
+		{
+		public:
+			Reference<Block> Node = {};
+			uint32_t Next = 0; // The next successor
+		};
+
+		std::vector<uint32_t> preorder(count, s_Unreachable); // Block -> index in vertices
+		std::vector<Reference<Block>> vertices = { };
+		std::vector<uint32_t> parents = { }; // By index in vertices
+
+		std::vector<Work> stack = { { function.GetEntry(), 0 } };
+		preorder[function.GetEntry().Index] = 0;
+		vertices.push_back(function.GetEntry());
+		parents.push_back(0);
+
+		while (!stack.empty())
+		{
+			const Work work = stack.back();
+			const std::span<const Reference<Block>> successors = function.GetSuccessors(work.Node);
+			if (work.Next < successors.size())
+			{
+				stack.back().Next++;
+
+				const Reference<Block> successor = successors[successors.size() - 1 - work.Next];
+				if (preorder[successor.Index] == s_Unreachable)
+				{
+					preorder[successor.Index] = static_cast<uint32_t>(vertices.size());
+					vertices.push_back(successor);
+					parents.push_back(preorder[work.Node.Index]);
+					stack.push_back({ successor, 0 });
+				}
+				continue;
+			}
+
+			m_ReversePostorder.push_back(work.Node);
+			stack.pop_back();
+		}
+
+		std::reverse(m_ReversePostorder.begin(), m_ReversePostorder.end());
+		for (size_t i = 0; i < m_ReversePostorder.size(); i++)
+			m_Order[m_ReversePostorder[i].Index] = static_cast<uint32_t>(i);
+
+		/////////////////////////////////////////////////////////////////
+		// Immediate dominators
+		/////////////////////////////////////////////////////////////////
+		// Note: Uses the semi-NCA algorithm on the preorder of the search, blocks are identified by
+		// their index in vertices here. Unlike the iterative algorithm a join of many branches doesn't
+		// walk up the dominators of every predecessor, which is quadratic for long else if chains.
+		const uint32_t reachable = static_cast<uint32_t>(vertices.size());
+		std::vector<uint32_t> semi(reachable);
+		std::vector<uint32_t> labels(reachable);
+		std::vector<uint32_t> ancestors(reachable, s_Unreachable);
+		for (uint32_t i = 0; i < reachable; i++)
+			semi[i] = labels[i] = i;
+
+		// Note: Returns the vertex with the lowest semidominator on the path from v to its linked root.
+		std::vector<uint32_t> path = { };
+		auto eval = [&](uint32_t v) -> uint32_t
+		{
+			if (ancestors[v] == s_Unreachable)
+				return v;
+
+			// Note: Compresses the path from the top down, like the recursive version would.
+			for (uint32_t u = v; ancestors[ancestors[u]] != s_Unreachable; u = ancestors[u])
+				path.push_back(u);
+
+			while (!path.empty())
+			{
+				const uint32_t u = path.back();
+				path.pop_back();
+
+				const uint32_t ancestor = ancestors[u];
+				if (semi[labels[ancestor]] < semi[labels[u]])
+					labels[u] = labels[ancestor];
+				ancestors[u] = ancestors[ancestor];
+			}
+
+			return labels[v];
+		};
+
+		for (uint32_t w = reachable - 1; w > 0; w--)
+		{
+			for (const Reference<Block> predecessor : function.GetBlock(vertices[w]).Predecessors)
+			{
+				const uint32_t v = preorder[predecessor.Index];
+				if (v == s_Unreachable)
+					continue;
+
+				semi[w] = std::min(semi[w], semi[eval(v)]);
+			}
+
+			ancestors[w] = parents[w];
+		}
+
+		std::vector<uint32_t> dominators(reachable, 0);
+		for (uint32_t w = 1; w < reachable; w++)
+		{
+			uint32_t dominator = parents[w];
+			while (dominator > semi[w])
+				dominator = dominators[dominator];
+
+			dominators[w] = dominator;
+		}
+
+		m_Dominators.assign(reachable, 0);
+		for (uint32_t w = 1; w < reachable; w++)
+			m_Dominators[m_Order[vertices[w].Index]] = m_Order[vertices[dominators[w]].Index];
+
+		/////////////////////////////////////////////////////////////////
+		// Children
+		/////////////////////////////////////////////////////////////////
+		for (uint32_t i = 1; i < reachable; i++)
+			m_ChildOffsets[m_ReversePostorder[m_Dominators[i]].Index + 1]++;
+		for (size_t i = 0; i < count; i++)
+			m_ChildOffsets[i + 1] += m_ChildOffsets[i];
+
+		std::vector<uint32_t> next(m_ChildOffsets.begin(), m_ChildOffsets.end() - 1);
+		m_Children.resize(reachable - 1);
+		for (uint32_t i = 1; i < reachable; i++)
+			m_Children[next[m_ReversePostorder[m_Dominators[i]].Index]++] = m_ReversePostorder[i];
+
+		/////////////////////////////////////////////////////////////////
+		// Preorder numbering
+		/////////////////////////////////////////////////////////////////
+		uint32_t number = 0;
+		stack.push_back({ function.GetEntry(), 0 });
+		m_Enter[function.GetEntry().Index] = number++;
+
+		while (!stack.empty())
+		{
+			const Work work = stack.back();
+			const std::span<const Reference<Block>> children = GetChildren(work.Node);
+			if (work.Next < children.size())
+			{
+				stack.back().Next++;
+
+				m_Enter[children[work.Next].Index] = number++;
+				stack.push_back({ children[work.Next], 0 });
+				continue;
+			}
+
+			m_Exit[work.Node.Index] = number;
+			stack.pop_back();
+		}
+	}
+
+	Reference<Block> DominatorTree::GetImmediateDominator(Reference<Block> block) const
+	{
+		const uint32_t order = m_Order[block.Index];
+		if (order == s_Unreachable || order == 0)
+			return { };
+
+		return m_ReversePostorder[m_Dominators[order]];
+	}
+
+	bool DominatorTree::Dominates(Reference<Block> dominator, Reference<Block> block) const
+	{
+		if (!IsReachable(dominator) || !IsReachable(block))
+			return false;
+
+		return (m_Enter[dominator.Index] <= m_Enter[block.Index] && m_Enter[block.Index] < m_Exit[dominator.Index]);
+	}
+
+	std::span<const Reference<Block>> DominatorTree::GetChildren(Reference<Block> block) const
+	{
+		return { m_Children.data() + m_ChildOffsets[block.Index], m_Children.data() + m_ChildOffsets[block.Index + 1] };
+	}
+
+}
\ No newline at end of file
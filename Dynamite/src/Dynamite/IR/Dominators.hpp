@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Dynamite/IR/IR.hpp"
+
+#include <span>
+#include <cstdint>
+#include <vector>
+
+namespace Dynamite::IR
+{
+
+	/////////////////////////////////////////////////////////////////
+	// Dominator tree
+	/////////////////////////////////////////////////////////////////
+	// Note: Built with the semi-NCA algorithm over a depth first search of the blocks.
+	// Blocks that can't be reached from the entry block aren't part of the tree.
+	// The tree is numbered in preorder, so checking if a block dominates another is O(1).
+	class DominatorTree
+	{
+	public:
+		DominatorTree(const Function& function);
+		~DominatorTree() = default;
+
+		// Returns the immediate dominator, an invalid reference for the entry & unreachable blocks.
+		Reference<Block> GetImmediateDominator(Reference<Block> block) const;
+		// Note: A block dominates itself.
+		bool Dominates(Reference<Block> dominator, Reference<Block> block) const;
+
+		inline bool IsReachable(Reference<Block> block) const { return m_Order[block.Index] != s_Unreachable; }
+
+		// Returns the blocks that are immediately dominated by block.
+		std::span<const Reference<Block>> GetChildren(Reference<Block> block) const;
+		// Note: The reachable blocks in reverse postorder, every block comes after its dominators.
+		inline const std::vector<Reference<Block>>& GetOrder() const { return m_ReversePostorder; }
+
+	private:
+		constexpr static const uint32_t s_Unreachable = static_cast<uint32_t>(-1);
+
+		std::vector<Reference<Block>> m_ReversePostorder = { };
+		std::vector<uint32_t> m_Order = { }; // Block -> index in m_ReversePostorder
+
+		std::vector<uint32_t> m_Dominators = { }; // Block -> immediate dominator, by index in m_ReversePostorder
+
+		// Note: The children of a block are [m_ChildOffsets[block], m_ChildOffsets[block + 1]).
+		std::vector<uint32_t> m_ChildOffsets = { };
+		std::vector<Reference<Block>> m_Children = { };
+
+		// Note: The preorder range of the subtree of a block, [Enter, Exit).
+		std::vector<uint32_t> m_Enter = { };
+		std::vector<uint32_t> m_Exit = { };
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include "dypch.h"
+#include "IR.hpp"
+
+#include "Dynamite/Core/Logging.hpp"
+
+#include <Pulse/Text/Format.hpp>
+
+namespace Dynamite::IR
+{
+
+	/////////////////////////////////////////////////////////////////
+	// Function
+	/////////////////////////////////////////////////////////////////
+	Function::Function(std::string_view name)
+		: m_Name(name)
+	{
+	}
+
+	Reference<Block> Function::AddBlock()
+	{
+		m_Blocks.emplace_back();
+		return { static_cast<uint32_t>(m_Blocks.size() - 1) };
+	}
+
+	Value Function::AddConstant(Reference<Block> block, const ConstantValue& value)
+	{
+		Instruction instruction = { Opcode::Constant, value.Type };
+		instruction.Constant = value;
+
+		return Add(block, instruction);
+	}
+
+	Value Function::AddBinary(Reference<Block> block, Opcode op, Value lhs, Value rhs)
+	{
+		return Add(block, { op, (IsComparison(op) ? ValueType::Bool : GetType(lhs)), {}, { lhs, rhs } });
+	}
+
+	Value Function::AddCast(Reference<Block> block, ValueType type, Value value)
+	{
+		return Add(block, { Opcode::Cast, type, {}, { value } });
+	}
+
+	Value Function::AddPhi(Reference<Block> block, ValueType type, std::span<const Value> operands)
+	{
+		Instruction instruction = { Opcode::Phi, type, block };
+		instruction.Phi = static_cast<uint32_t>(m_PhiOperands.size());
+		m_PhiOperands.emplace_back(operands.begin(), operands.end());
+
+		m_Instructions.push_back(instruction);
+		const Value value = { static_cast<uint32_t>(m_Instructions.size() - 1) };
+
+		std::vector<Value>& instructions = m_Blocks[block.Index].Instructions;
+		auto position = std::find_if(instructions.begin(), instructions.end(), [this](Value other) { return Get(other).Op != Opcode::Phi; });
+		instructions.insert(position, value);
+
+		return value;
+	}
+
+	void Function::AddJump(Reference<Block> block, Reference<Block> target)
+	{
+		Instruction instruction = { Opcode::Jump };
+		instruction.Targets = { target };
+
+		Add(block, instruction);
+		m_Blocks[target.Index].Predecessors.push_back(block);
+	}
+
+	void Function::AddBranch(Reference<Block> block, Value condition, Reference<Block> onTrue, Reference<Block> onFalse)
+	{
+		Instruction instruction = { Opcode::Branch, ValueType::None, {}, { condition } };
+		instruction.Targets = { onTrue, onFalse };
+
+		Add(block, instruction);
+		m_Blocks[onTrue.Index].Predecessors.push_back(block);
+		m_Blocks[onFalse.Index].Predecessors.push_back(block);
+	}
+
+	void Function::AddExit(Reference<Block> block, Value code)
+	{
+		Add(block, { Opcode::Exit, ValueType::None, {}, { code } });
+	}
+
+	void Function::Remove(std::span<const Value> values)
+	{
+		std::vector<bool> removed(m_Instructions.size(), false);
+		for (const Value value : values)
+			removed[value.Index] = true;
+
+		for (Block& block : m_Blocks)
+			std::erase_if(block.Instructions, [&removed](Value value) { return removed[value.Index]; });
+	}
+
+	void Function::ReplaceOperands(std::span<const Value> replacements)
+	{
+		for (Instruction& instruction : m_Instructions)
+		{
+			for (Value& operand : instruction.Operands)
+			{
+				if (operand.IsValid())
+					operand = replacements[operand.Index];
+			}
+		}
+
+		for (std::vector<Value>& operands : m_PhiOperands)
+		{
+			for (Value& operand : operands)
+				operand = replacements[operand.Index];
+		}
+	}
+
+	std::span<const Value> Function::GetOperands(Value value) const
+	{
+		const Instruction& instruction = Get(value);
+		switch (instruction.Op)
+		{
+		case Opcode::Phi:
+			return m_PhiOperands[instruction.Phi];
+
+		case Opcode::Cast:
+		case Opcode::Branch:
+		case Opcode::Exit:
+			return { instruction.Operands.data(), 1 };
+
+		default:
+			break;
+		}
+
+		if (IsBinary(instruction.Op))
+			return { instruction.Operands.data(), 2 };
+
+		return { };
+	}
+
+	Value Function::GetTerminator(Reference<Block> block) const
+	{
+		const std::vector<Value>& instructions = GetBlock(block).Instructions;
+		if (instructions.empty() || !IsTerminator(Get(instructions.back()).Op))
+			return { };
+
+		return instructions.back();
+	}
+
+	std::span<const Reference<Block>> Function::GetSuccessors(Reference<Block> block) const
+	{
+		const Value terminator = GetTerminator(block);
+		if (!terminator.IsValid())
+			return { };
+
+		const Instruction& instruction = Get(terminator);
+		switch (instruction.Op)
+		{
+		case Opcode::Jump:		return { instruction.Targets.data(), 1 };
+		case Opcode::Branch:	return { instruction.Targets.data(), 2 };
+
+		default:
+			break;
+		}
+
+		return { };
+	}
+
+	Value Function::Add(Reference<Block> block, const Instruction& instruction)
+	{
+		m_Instructions.push_back(instruction);
+		m_Instructions.back().Parent = block;
+
+		const Value value = { static_cast<uint32_t>(m_Instructions.size() - 1) };
+		m_Blocks[block.Index].Instructions.push_back(value);
+
+		return value;
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// Helper functions
+	/////////////////////////////////////////////////////////////////
+	std::string_view OpcodeToStr(Opcode op)
+	{
+		switch (op)
+		{
+		case Opcode::Constant:		return "const";
+
+		case Opcode::Add:			return "add";
+		case Opcode::Sub:			return "sub";
+		case Opcode::Mul:			return "mul";
+		case Opcode::Div:			return "div";
+		case Opcode::Or:			return "or";
+		case Opcode::And:			return "and";
+		case Opcode::Xor:			return "xor";
+
+		case Opcode::Equal:			return "eq";
+		case Opcode::NotEqual:		return "ne";
+		case Opcode::Less:			return "lt";
+		case Opcode::Greater:		return "gt";
+		case Opcode::LessEqual:		return "le";
+		case Opcode::GreaterEqual:	return "ge";
+
+		case Opcode::Cast:			return "cast";
+		case Opcode::Phi:			return "phi";
+
+		case Opcode::Jump:			return "jump";
+		case Opcode::Branch:		return "branch";
+		case Opcode::Exit:			return "exit";
+
+		default:
+			break;
+		}
+
+		return "UNDEFINED Opcode";
+	}
+
+	std::string FormatValue(Value value)
+	{
+		return (value.IsValid() ? Pulse::Text::Format("%{0}", value.Index) : std::string("%?"));
+	}
+
+	std::string FormatBlock(const Function& function, Reference<Block> block)
+	{
+		std::string str = Pulse::Text::Format(".{0}:", block.Index);
+
+		const std::vector<Reference<Block>>& predecessors = function.GetBlock(block).Predecessors;
+		for (size_t i = 0; i < predecessors.size(); i++)
+			str += Pulse::Text::Format("{0}.{1}", (i == 0 ? " ; preds " : ", "), predecessors[i].Index);
+
+		return str;
+	}
+
+	std::string FormatInstruction(const Function& function, Value value)
+	{
+		const Instruction& instruction = function.Get(value);
+		const std::span<const Value> operands = function.GetOperands(value);
+
+		std::string str = "    ";
+		if (instruction.Type != ValueType::None)
+			str += Pulse::Text::Format("{0} = {1} {2}", FormatValue(value), OpcodeToStr(instruction.Op), ValueTypeToStr(instruction.Type));
+		else
+			str += std::string(OpcodeToStr(instruction.Op));
+
+		switch (instruction.Op)
+		{
+		case Opcode::Constant:
+			str += " " + FormatConstantValue(instruction.Constant);
+			break;
+
+		case Opcode::Phi:
+		{
+			const std::vector<Reference<Block>>& predecessors = function.GetBlock(instruction.Parent).Predecessors;
+			for (size_t i = 0; i < operands.size(); i++)
+				str += Pulse::Text::Format("{0}[.{1}: {2}]", (i == 0 ? " " : ", "), (i < predecessors.size() ? predecessors[i].Index : Reference<Block>::InvalidIndex), FormatValue(operands[i]));
+			break;
+		}
+
+		default:
+		{
+			for (size_t i = 0; i < operands.size(); i++)
+				str += (i == 0 ? " " : ", ") + FormatValue(operands[i]);
+
+			const size_t targets = (instruction.Op == Opcode::Branch ? 2 : (instruction.Op == Opcode::Jump ? 1 : 0));
+			for (size_t i = 0; i < targets; i++)
+				str += Pulse::Text::Format("{0}.{1}", (i == 0 && operands.empty() ? " " : ", "), instruction.Targets[i].Index);
+			break;
+		}
+		}
+
+		return str;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "Dynamite/Parsing/Variables.hpp"
+
+#include <array>
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace Dynamite::IR
+{
+
+	// Internal reference type.
+	// Note: A 32 bit index into a Function, T is the kind of object
+	// it refers to so references to blocks & instructions can't be mixed up.
+	template<typename T>
+	struct Reference
+	{
+	public:
+		constexpr static const uint32_t InvalidIndex = static_cast<uint32_t>(-1);
+
+		uint32_t Index = InvalidIndex;
+
+	public:
+		inline bool IsValid() const { return Index != InvalidIndex; }
+
+		inline bool operator == (const Reference<T>& other) const { return Index == other.Index; }
+		inline bool operator != (const Reference<T>& other) const { return Index != other.Index; }
+	};
+
+	struct Block;
+	struct Instruction;
+
+	// Note: An instruction with a type defines a value, the value is referred to by its instruction.
+	using Value = Reference<Instruction>;
+
+	/////////////////////////////////////////////////////////////////
+	// Opcodes
+	/////////////////////////////////////////////////////////////////
+	enum class Opcode : uint8_t
+	{
+		None = 0,
+
+		Constant,
+
+		// Note: Both operands have the type of the result.
+		Add, Sub, Mul, Div,
+		Or, And, Xor,
+
+		// Note: Both operands have the same type, the result is a bool.
+		Equal, NotEqual, Less, Greater, LessEqual, GreaterEqual,
+
+		Cast,
+		Phi,
+
+		// Terminators
+		Jump, Branch, Exit
+	};
+
+	constexpr bool IsArithmetic(Opcode op) { return (op >= Opcode::Add && op <= Opcode::Xor); }
+	constexpr bool IsComparison(Opcode op) { return (op >= Opcode::Equal && op <= Opcode::GreaterEqual); }
+	constexpr bool IsBinary(Opcode op) { return (IsArithmetic(op) || IsComparison(op)); }
+	constexpr bool IsTerminator(Opcode op) { return (op >= Opcode::Jump && op <= Opcode::Exit); }
+
+	/////////////////////////////////////////////////////////////////
+	// Instructions & blocks
+	/////////////////////////////////////////////////////////////////
+	struct Instruction
+	{
+	public:
+		constexpr static const uint32_t NoPhi = static_cast<uint32_t>(-1);
+
+		Opcode Op = Opcode::None;
+		ValueType Type = ValueType::None; // Of the result, None if there is no result
+		Reference<Block> Parent = {};
+
+		// Note: Phis keep their operands in the Function, Phi is the index of them.
+		std::array<Value, 2> Operands = { };
+		std::array<Reference<Block>, 2> Targets = { }; // Jump: the target, Branch: true & false
+		uint32_t Phi = NoPhi;
+
+		ConstantValue Constant = {}; // Only for Opcode::Constant
+	};
+
+	struct Block
+	{
+	public:
+		// Note: Phis come first and the terminator is last.
+		std::vector<Value> Instructions = { };
+		// Note: The operands of the phis of the block are in the same order.
+		std::vector<Reference<Block>> Predecessors = { };
+	};
+
+	/////////////////////////////////////////////////////////////////
+	// Function
+	/////////////////////////////////////////////////////////////////
+	// Note: Owns the blocks & instructions of a function in SSA form, every
+	// value is defined once and the first block is the entry block.
+	class Function
+	{
+	public:
+		Function(std::string_view name = {});
+		~Function() = default;
+
+		Reference<Block> AddBlock();
+
+		// Note: Instructions are appended to the block, phis are added after the phis of the block.
+		Value AddConstant(Reference<Block> block, const ConstantValue& value);
+		// Note: The type is a bool for comparisons, otherwise the type of lhs.
+		Value AddBinary(Reference<Block> block, Opcode op, Value lhs, Value rhs);
+		Value AddCast(Reference<Block> block, ValueType type, Value value);
+		// Note: Takes an operand for every predecessor of the block.
+		Value AddPhi(Reference<Block> block, ValueType type, std::span<const Value> operands);
+
+		// Note: Terminators add the block to the predecessors of their
+		// targets, so they have to be added before the phis of the targets.
+		void AddJump(Reference<Block> block, Reference<Block> target);
+		void AddBranch(Reference<Block> block, Value condition, Reference<Block> onTrue, Reference<Block> onFalse);
+		void AddExit(Reference<Block> block, Value code);
+
+		// Note: Removes the instructions from their blocks, they stay in the function so references
+		// stay valid. The removed instructions mustn't be used by the instructions that are left.
+		void Remove(std::span<const Value> values);
+		// Note: Replaces every operand (also of phis & terminators) with replacements[operand.Index],
+		// so it takes a value for every instruction. The replacement has to dominate the uses.
+		void ReplaceOperands(std::span<const Value> replacements);
+
+		// Getters
+		inline Reference<Block> GetEntry() const { return { 0 }; }
+
+		inline const Block& GetBlock(Reference<Block> block) const { return m_Blocks[block.Index]; }
+		inline const Instruction& Get(Value value) const { return m_Instructions[value.Index]; }
+		inline ValueType GetType(Value value) const { return m_Instructions[value.Index].Type; }
+
+		std::span<const Value> GetOperands(Value value) const;
+		// Returns the terminator of the block, an invalid value if the block has none (yet).
+		Value GetTerminator(Reference<Block> block) const;
+		std::span<const Reference<Block>> GetSuccessors(Reference<Block> block) const;
+
+		inline const std::string& GetName() const { return m_Name; }
+		inline size_t BlockCount() const { return m_Blocks.size(); }
+		inline size_t InstructionCount() const { return m_Instructions.size(); }
+
+	private:
+		Value Add(Reference<Block> block, const Instruction& instruction);
+
+	private:
+		std::string m_Name;
+
+		std::vector<Block> m_Blocks = { };
+		std::vector<Instruction> m_Instructions = { };
+		std::vector<std::vector<Value>> m_PhiOperands = { };
+	};
+
+	// Note: The functions of a compilation unit.
+	struct Module
+	{
+	public:
+		std::vector<Function> Functions = { };
+	};
+
+	/////////////////////////////////////////////////////////////////
+	// Helper functions
+	/////////////////////////////////////////////////////////////////
+	std::string_view OpcodeToStr(Opcode op);
+
+	std::string FormatValue(Value value);
+	std::string FormatBlock(const Function& function, Reference<Block> block);
+	std::string FormatInstruction(const Function& function, Value value);
+
+}
\ No newline at end of file
@@ -0,0 +1,361 @@
+#include "dypch.h"
+#include "Lowering.hpp"
+
+#include "Dynamite/Core/Logging.hpp"
+
+namespace Dynamite::IR
+{
+
+	namespace
+	{
+		static Opcode GetOpcode(Node::BinaryExpr::Type type)
+		{
+			switch (type)
+			{
+			case Node::BinaryExpr::Type::Addition:			return Opcode::Add;
+			case Node::BinaryExpr::Type::Subtraction:		return Opcode::Sub;
+			case Node::BinaryExpr::Type::Multiplication:	return Opcode::Mul;
+			case Node::BinaryExpr::Type::Division:			return Opcode::Div;
+
+			case Node::BinaryExpr::Type::Or:				return Opcode::Or;
+			case Node::BinaryExpr::Type::And:				return Opcode::And;
+			case Node::BinaryExpr::Type::Xor:				return Opcode::Xor;
+
+			case Node::BinaryExpr::Type::Equal:				return Opcode::Equal;
+			case Node::BinaryExpr::Type::NotEqual:			return Opcode::NotEqual;
+			case Node::BinaryExpr::Type::Less:				return Opcode::Less;
+			case Node::BinaryExpr::Type::Greater:			return Opcode::Greater;
+			case Node::BinaryExpr::Type::LessEqual:			return Opcode::LessEqual;
+			case Node::BinaryExpr::Type::GreaterEqual:		return Opcode::GreaterEqual;
+
+			// Note: Expressions have no side effects, so both operands of a logical operator
+			// are always evaluated. They're bitwise operators on bools.
+			case Node::BinaryExpr::Type::LogicalAnd:		return Opcode::And;
+			case Node::BinaryExpr::Type::LogicalOr:			return Opcode::Or;
+
+			default:
+				break;
+			}
+
+			return Opcode::None;
+		}
+	}
+
+	Lowering::Lowering(const Node::Program& program)
+		: Node::Visitor<Lowering>(program), m_Function("main")
+	{
+	}
+
+	Module Lowering::Lower()
+	{
+		m_Current = m_Function.AddBlock();
+		Walk();
+
+		// Default exit code of 0
+		if (m_Current.IsValid())
+			m_Function.AddExit(m_Current, GetZero(ValueType::UInt8));
+
+		Module module = {};
+		module.Functions.push_back(std::move(m_Function));
+		return module;
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// Hooks
+	/////////////////////////////////////////////////////////////////
+	Node::VisitResult Lowering::PreStatement(Node::Reference<Node::Statement> statement)
+	{
+		if (!m_Current.IsValid())
+			return Node::VisitResult::SkipChildren;
+
+		switch (GetProgram().GetKind(statement))
+		{
+		case Node::Statement::Kind::Variable:
+		{
+			// Note: Like in the parser the variable is in scope in its own expression, it's 0 there.
+			const Node::VariableStatement& variable = GetProgram().GetVariable(statement);
+			m_Variables.Push(variable.Symbol, m_Values.Add({}));
+			m_Types.push_back(variable.Type);
+			break;
+		}
+		case Node::Statement::Kind::If:
+		{
+			const Node::IfStatement& ifStatement = GetProgram().GetIf(statement);
+			m_Conditions.push_back({ statement, ifStatement.ExprObj, ifStatement.Scope });
+
+			m_Conditions.back().FirstEnd = m_Ends.size();
+			m_Values.BeginIf();
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		return Node::VisitResult::Continue;
+	}
+
+	Node::VisitResult Lowering::PostStatement(Node::Reference<Node::Statement> statement)
+	{
+		const Node::Statement::Kind kind = GetProgram().GetKind(statement);
+		if (kind == Node::Statement::Kind::If)
+		{
+			// Note: Unreachable if statements are skipped, they have no condition.
+			if (!m_Conditions.empty() && m_Conditions.back().Statement == statement)
+				Join();
+
+			return Node::VisitResult::Continue;
+		}
+
+		if (!m_Current.IsValid())
+			return Node::VisitResult::Continue;
+
+		switch (kind)
+		{
+		case Node::Statement::Kind::Variable:
+		{
+			const Node::VariableStatement& variable = GetProgram().GetVariable(statement);
+			m_Values[*m_Variables.Find(variable.Symbol)] = Pop(variable.ExprObj, variable.Type);
+			break;
+		}
+		case Node::Statement::Kind::Assignment:
+		{
+			const Node::AssignmentStatement& assignment = GetProgram().GetAssignment(statement);
+
+			// Note: Assignments to undeclared variables have been reported by the parser.
+			const uint32_t* slot = m_Variables.Find(assignment.Symbol);
+			if (!slot)
+			{
+				Pop(assignment.ExprObj, ValueType::None);
+				break;
+			}
+
+			m_Values.Assign(*slot, Pop(assignment.ExprObj, m_Types[*slot]));
+			break;
+		}
+		case Node::Statement::Kind::Exit:
+		{
+			m_Function.AddExit(m_Current, Pop(GetProgram().GetExit(statement), ValueType::UInt8));
+			m_Current = {};
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		return Node::VisitResult::Continue;
+	}
+
+	Node::VisitResult Lowering::PostExpression(Node::Reference<Node::Expression> expr)
+	{
+		switch (GetProgram().GetKind(expr))
+		{
+		case Node::Expression::Kind::Literal:
+		{
+			m_Stack.push_back(m_Function.AddConstant(m_Current, GetProgram().GetLiteral(expr).Value));
+			break;
+		}
+		case Node::Expression::Kind::Identifier:
+		{
+			const uint32_t* slot = m_Variables.Find(GetProgram().GetIdentifier(expr).Symbol);
+			if (slot && m_Values[*slot].IsValid())
+				m_Stack.push_back(m_Values[*slot]);
+			else
+				m_Stack.push_back(GetZero(slot ? m_Types[*slot] : GetProgram().GetType(expr)));
+			break;
+		}
+		case Node::Expression::Kind::Binary:
+		{
+			const Node::BinaryExpr& binary = GetProgram().GetBinary(expr);
+			const ValueType type = GetProgram().GetType(expr);
+
+			// Note: Operands that failed to parse are 0.
+			Value rhs = Pop(binary.RHS, ValueType::None);
+			Value lhs = Pop(binary.LHS, ValueType::None);
+			if (!lhs.IsValid())
+				lhs = GetZero(rhs.IsValid() ? m_Function.GetType(rhs) : type);
+			if (!rhs.IsValid())
+				rhs = GetZero(m_Function.GetType(lhs));
+
+			const Opcode op = GetOpcode(binary.BinaryType);
+			ValueType operandType = type;
+			if (binary.BinaryType == Node::BinaryExpr::Type::LogicalAnd || binary.BinaryType == Node::BinaryExpr::Type::LogicalOr)
+				operandType = ValueType::Bool;
+			else if (IsComparison(op))
+				operandType = ValueTypePromote(m_Function.GetType(lhs), m_Function.GetType(rhs));
+
+			m_Stack.push_back(m_Function.AddBinary(m_Current, op, Cast(lhs, operandType), Cast(rhs, operandType)));
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		return Node::VisitResult::Continue;
+	}
+
+	Node::VisitResult Lowering::PreScope(Node::Reference<Node::ScopeStatement> scope)
+	{
+		if (!m_Conditions.empty() && m_Conditions.back().Scope == scope && !m_Conditions.back().InArm)
+			BeginArm();
+
+		m_Variables.PushScope();
+		return Node::VisitResult::Continue;
+	}
+
+	Node::VisitResult Lowering::PostScope(Node::Reference<Node::ScopeStatement> scope)
+	{
+		m_Variables.PopScope();
+
+		if (!m_Conditions.empty() && m_Conditions.back().Scope == scope && m_Conditions.back().InArm)
+			EndArm();
+
+		return Node::VisitResult::Continue;
+	}
+
+	Node::VisitResult Lowering::PreBranch(Node::Reference<Node::ConditionBranch> branch)
+	{
+		Condition& condition = m_Conditions.back();
+		switch (GetProgram().GetKind(branch))
+		{
+		case Node::ConditionBranch::Kind::ElseIf:
+		{
+			const Node::ElseIfBranch& elseIf = GetProgram().GetElseIf(branch);
+			condition.ExprObj = elseIf.ExprObj;
+			condition.Scope = elseIf.Scope;
+			break;
+		}
+		case Node::ConditionBranch::Kind::Else:
+		{
+			condition.ExprObj = {};
+			condition.Scope = GetProgram().GetElse(branch);
+			condition.Else = true;
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		return Node::VisitResult::Continue;
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// Helpers
+	/////////////////////////////////////////////////////////////////
+	Value Lowering::GetZero(ValueType type)
+	{
+		ConstantValue zero = {};
+		zero.Type = type;
+		if (type != ValueType::String)
+			zero.UInt = 0;
+
+		return m_Function.AddConstant(m_Current, zero);
+	}
+
+	Value Lowering::Cast(Value value, ValueType type)
+	{
+		if (type == ValueType::None || m_Function.GetType(value) == type)
+			return value;
+
+		// Note: Constants are cast while lowering, so they stay constants. Unless the
+		// cast isn't defined (like out of range floats), then it's left to the runtime.
+		const Instruction& instruction = m_Function.Get(value);
+		if (instruction.Op == Opcode::Constant)
+		{
+			const std::optional<ConstantValue> constant = ValueTypeConvert(type, instruction.Constant);
+			if (constant.has_value())
+				return m_Function.AddConstant(m_Current, constant.value());
+		}
+
+		return m_Function.AddCast(m_Current, type, value);
+	}
+
+	Value Lowering::Pop(Node::Reference<Node::Expression> expr, ValueType type)
+	{
+		if (!expr.IsValid())
+			return (type == ValueType::None ? Value() : GetZero(type));
+
+		const Value value = m_Stack.back();
+		m_Stack.pop_back();
+
+		return Cast(value, type);
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// If statements
+	/////////////////////////////////////////////////////////////////
+	void Lowering::BeginArm()
+	{
+		Condition& condition = m_Conditions.back();
+
+		// Note: An else branch starts where the previous condition was false.
+		if (condition.Else)
+			condition.Next = {};
+		else
+		{
+			const Value value = Pop(condition.ExprObj, ValueType::Bool);
+
+			const Reference<Block> arm = m_Function.AddBlock();
+			const Reference<Block> next = m_Function.AddBlock();
+			m_Function.AddBranch(m_Current, value, arm, next);
+
+			m_Current = arm;
+			condition.Next = next;
+		}
+
+		condition.InArm = true;
+		m_Values.BeginBranch();
+	}
+
+	void Lowering::EndArm()
+	{
+		Condition& condition = m_Conditions.back();
+
+		if (m_Current.IsValid())
+			m_Ends.push_back(m_Current);
+		m_Values.EndBranch(m_Current.IsValid());
+
+		condition.InArm = false;
+		m_Current = condition.Next;
+	}
+
+	void Lowering::Join()
+	{
+		const Condition condition = m_Conditions.back();
+		m_Conditions.pop_back();
+
+		// Note: Without an else branch we continue where the last condition was false.
+		if (m_Current.IsValid())
+		{
+			m_Ends.push_back(m_Current);
+			m_Values.AddPath();
+		}
+
+		const std::span<const Reference<Block>> ends = { m_Ends.data() + condition.FirstEnd, m_Ends.size() - condition.FirstEnd };
+		if (ends.empty())
+			m_Current = {};
+		else if (ends.size() == 1)
+			m_Current = ends[0];
+		else
+		{
+			m_Current = m_Function.AddBlock();
+			for (const Reference<Block> end : ends)
+				m_Function.AddJump(end, m_Current);
+		}
+
+		// Note: A variable that has different values at the end of the paths gets a phi.
+		m_Values.EndIf([&](uint32_t slot, std::span<const Value> incoming)
+		{
+			if (std::all_of(incoming.begin(), incoming.end(), [&](Value value) { return value == incoming[0]; }))
+				return incoming[0];
+
+			return m_Function.AddPhi(m_Current, m_Types[slot], incoming);
+		});
+
+		m_Ends.resize(condition.FirstEnd);
+	}
+
+}
\ No newline at end of file
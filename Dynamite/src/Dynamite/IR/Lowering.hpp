@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Dynamite/Core/SymbolTable.hpp"
+#include "Dynamite/Core/BranchValues.hpp"
+
+#include "Dynamite/Parsing/Nodes.hpp"
+#include "Dynamite/Parsing/Visitor.hpp"
+
+#include "Dynamite/IR/IR.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Dynamite::IR
+{
+
+	/////////////////////////////////////////////////////////////////
+	// Lowering
+	/////////////////////////////////////////////////////////////////
+	// Note: Lowers the tree of a Program to the function "main". Variables become SSA
+	// values, an assignment just changes the value a variable refers to. Every if, else if
+	// & else chain becomes a branch per condition and the branches that don't exit join
+	// again, a variable that has different values on the way in gets a phi there.
+	// Code after an exit() can't be reached and isn't lowered.
+	class Lowering : public Node::Visitor<Lowering>
+	{
+	public:
+		Lowering(const Node::Program& program);
+		~Lowering() = default;
+
+		Module Lower();
+
+	public:
+		// Hooks
+		Node::VisitResult PreStatement(Node::Reference<Node::Statement> statement);
+		Node::VisitResult PostStatement(Node::Reference<Node::Statement> statement);
+		Node::VisitResult PostExpression(Node::Reference<Node::Expression> expr);
+		Node::VisitResult PreScope(Node::Reference<Node::ScopeStatement> scope);
+		Node::VisitResult PostScope(Node::Reference<Node::ScopeStatement> scope);
+		Node::VisitResult PreBranch(Node::Reference<Node::ConditionBranch> branch);
+
+	private:
+		Value GetZero(ValueType type);
+		// Note: Casting to ValueType::None keeps the value.
+		Value Cast(Value value, ValueType type);
+
+		// Returns the value of the expression cast to type, zero if the expression failed to parse.
+		// Note: With ValueType::None an invalid value is returned instead of zero.
+		Value Pop(Node::Reference<Node::Expression> expr, ValueType type);
+
+		// Note: The steps of lowering an if statement.
+		void BeginArm();
+		void EndArm();
+		void Join();
+
+	private:
+		Function m_Function;
+		Reference<Block> m_Current = {}; // Invalid if the code can't be reached
+
+		// Note: Every variable has a slot with its current value.
+		ScopedSymbolTable<uint32_t> m_Variables = { };
+		BranchValues<Value> m_Values = { };
+		std::vector<ValueType> m_Types = { };
+
+		// Note: The values of the expressions that are being lowered.
+		std::vector<Value> m_Stack = { };
+
+		struct Condition
+		{
+		public:
+			Node::Reference<Node::Statement> Statement = {};
+			// Note: Of the branch that is being lowered or comes next.
+			Node::Reference<Node::Expression> ExprObj = {};
+			Node::Reference<Node::ScopeStatement> Scope = {};
+			bool InArm = false;
+			bool Else = false;
+
+			Reference<Block> Next = {}; // Where the next branch starts, if no condition is true
+			size_t FirstEnd = 0; // Into m_Ends
+		};
+
+		// Note: The last block of every path that continues after the if statements, in the same order as the paths of m_Values.
+		std::vector<Reference<Block>> m_Ends = { };
+		std::vector<Condition> m_Conditions = { };
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "dypch.h"
+#include "ValueNumbering.hpp"
+
+#include "Dynamite/IR/Dominators.hpp"
+
+namespace Dynamite::IR
+{
+
+	namespace
+	{
+		// Note: What an instruction computes, the operands are value numbers. Bits is only used for constants.
+		struct Expression
+		{
+		public:
+			Opcode Op = Opcode::None;
+			ValueType Type = ValueType::None;
+			std::array<uint32_t, 2> Operands = { Value::InvalidIndex, Value::InvalidIndex };
+			uint64_t Bits = 0;
+
+		public:
+			inline bool operator == (const Expression& other) const = default;
+		};
+
+		struct ExpressionHash
+		{
+		public:
+			size_t operator () (const Expression& expression) const
+			{
+				uint64_t hash = (static_cast<uint64_t>(expression.Op) << 8) | static_cast<uint64_t>(expression.Type);
+				hash = (hash ^ expression.Operands[0]) * 0x9E3779B97F4A7C15ull;
+				hash = (hash ^ expression.Operands[1]) * 0x9E3779B97F4A7C15ull;
+				hash = (hash ^ expression.Bits) * 0x9E3779B97F4A7C15ull;
+				return static_cast<size_t>(hash ^ (hash >> 32));
+			}
+		};
+
+		// Note: Blocks are visited twice while walking the dominator tree, the second
+		// time (with the amount of expressions before it in Added) removes the expressions it added.
+		struct Step
+		{
+		public:
+			constexpr static const size_t Enter = static_cast<size_t>(-1);
+
+			Reference<Block> BlockRef = {};
+			size_t Added = Enter;
+		};
+
+		// Note: Floats are commutative as well, a + b gives the same bits as b + a.
+		static bool IsCommutative(Opcode op)
+		{
+			switch (op)
+			{
+			case Opcode::Add:
+			case Opcode::Mul:
+			case Opcode::Or:
+			case Opcode::And:
+			case Opcode::Xor:
+			case Opcode::Equal:
+			case Opcode::NotEqual:
+				return true;
+
+			default:
+				break;
+			}
+
+			return false;
+		}
+
+		// Note: Returns an expression with Opcode::None if the value can't be numbered, like phis & terminators.
+		static Expression GetExpression(const Function& function, Value value, const std::vector<Value>& numbers)
+		{
+			const Instruction& instruction = function.Get(value);
+			if (instruction.Op == Opcode::Constant)
+			{
+				if (instruction.Type == ValueType::String)
+					return { };
+
+				return { Opcode::Constant, instruction.Type, { Value::InvalidIndex, Value::InvalidIndex }, GetConstantBits(instruction.Constant) };
+			}
+
+			if (instruction.Op == Opcode::Cast)
+				return { Opcode::Cast, instruction.Type, { numbers[instruction.Operands[0].Index].Index, Value::InvalidIndex }, 0 };
+
+			if (!IsBinary(instruction.Op))
+				return { };
+
+			Expression expression = { instruction.Op, instruction.Type, { numbers[instruction.Operands[0].Index].Index, numbers[instruction.Operands[1].Index].Index }, 0 };
+			if (IsCommutative(instruction.Op) && expression.Operands[1] < expression.Operands[0])
+				std::swap(expression.Operands[0], expression.Operands[1]);
+
+			return expression;
+		}
+	}
+
+	size_t RemoveCommonSubexpressions(Function& function)
+	{
+		if (function.BlockCount() == 0)
+			return 0;
+
+		const DominatorTree dominators(function);
+
+		// Note: The value number of every value is the first value (in the dominator tree) that computes the same.
+		std::vector<Value> numbers(function.InstructionCount());
+		for (uint32_t i = 0; i < numbers.size(); i++)
+			numbers[i] = { i };
+
+		// Note: The expressions computed by the blocks that dominate the current block, the
+		// expressions of a block are removed again when all blocks it dominates are done.
+		std::unordered_map<Expression, Value, ExpressionHash> available = { };
+		std::vector<Expression> added = { };
+		std::vector<Value> redundant = { };
+
+		std::vector<Step> steps = { { function.GetEntry() } };
+		while (!steps.empty())
+		{
+			const Step step = steps.back();
+			steps.pop_back();
+
+			if (step.Added != Step::Enter)
+			{
+				while (added.size() > step.Added)
+				{
+					available.erase(added.back());
+					added.pop_back();
+				}
+
+				continue;
+			}
+
+			steps.push_back({ step.BlockRef, added.size() });
+
+			// Note: The operands of an instruction (but phis) are defined before
+			// it in the dominator tree, so they've been numbered already.
+			for (const Value value : function.GetBlock(step.BlockRef).Instructions)
+			{
+				const Expression expression = GetExpression(function, value, numbers);
+				if (expression.Op == Opcode::None)
+					continue;
+
+				// Note: A division that traps is reached through the one that dominates it, which traps first.
+				auto [it, inserted] = available.try_emplace(expression, value);
+				if (inserted)
+					added.push_back(expression);
+				else
+				{
+					numbers[value.Index] = it->second;
+					redundant.push_back(value);
+				}
+			}
+
+			for (const Reference<Block> child : dominators.GetChildren(step.BlockRef))
+				steps.push_back({ child });
+		}
+
+		if (redundant.empty())
+			return 0;
+
+		function.ReplaceOperands(numbers);
+		function.Remove(redundant);
+		return redundant.size();
+	}
+
+	size_t RemoveCommonSubexpressions(Module& module)
+	{
+		size_t removed = 0;
+		for (Function& function : module.Functions)
+			removed += RemoveCommonSubexpressions(function);
+
+		return removed;
+	}
+
+}
\ No newline at end of file
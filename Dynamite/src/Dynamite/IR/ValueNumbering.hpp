@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Dynamite/IR/IR.hpp"
+
+#include <cstddef>
+
+namespace Dynamite::IR
+{
+
+	// Removes the instructions that compute a value which is already computed by an instruction that
+	// dominates them & uses that value instead (global value numbering). Two instructions compute
+	// the same value if they have the same opcode, type & operands, operands of commutative
+	// operations are compared in any order. Since every assignment defines a new value, an
+	// expression that uses a variable is only the same if the variable wasn't assigned in between.
+	// Returns the amount of instructions that were removed.
+	size_t RemoveCommonSubexpressions(Function& function);
+	size_t RemoveCommonSubexpressions(Module& module);
+
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "dypch.h"
+#include "Verifier.hpp"
+
+#include "Dynamite/Core/Logging.hpp"
+
+#include "Dynamite/IR/Dominators.hpp"
+
+namespace Dynamite::IR
+{
+
+	namespace
+	{
+		constexpr static const uint32_t s_NotPlaced = static_cast<uint32_t>(-1);
+
+		// Returns the type both operands must have, ValueType::None if any type is allowed.
+		static ValueType GetOperandType(const Function& function, const Instruction& instruction)
+		{
+			switch (instruction.Op)
+			{
+			case Opcode::Branch:	return ValueType::Bool;
+			case Opcode::Exit:		return ValueType::UInt8;
+			case Opcode::Phi:		return instruction.Type;
+
+			default:
+				break;
+			}
+
+			if (IsArithmetic(instruction.Op))
+				return instruction.Type;
+			if (IsComparison(instruction.Op))
+				return function.GetType(instruction.Operands[0]);
+
+			return ValueType::None;
+		}
+	}
+
+	bool Verify(const Function& function)
+	{
+		bool valid = true;
+		auto report = [&](const std::string& problem, Reference<Block> block, Value value)
+		{
+			DY_LOG_ERROR("IR verification of '{0}' failed, {1}.\n{2}\n{3}", function.GetName(), problem, FormatBlock(function, block), (value.IsValid() ? FormatInstruction(function, value) : std::string()));
+			valid = false;
+		};
+
+		if (function.BlockCount() == 0)
+		{
+			DY_LOG_ERROR("IR verification of '{0}' failed, it has no blocks.", function.GetName());
+			return false;
+		}
+
+		/////////////////////////////////////////////////////////////////
+		// Structure
+		/////////////////////////////////////////////////////////////////
+		// Note: The position of every instruction in its block, s_NotPlaced if it isn't in a block.
+		std::vector<uint32_t> positions(function.InstructionCount(), s_NotPlaced);
+		std::vector<std::vector<uint32_t>> edges(function.BlockCount());
+
+		if (!function.GetBlock(function.GetEntry()).Predecessors.empty())
+			report("the entry block has predecessors", function.GetEntry(), {});
+
+		for (uint32_t i = 0; i < function.BlockCount(); i++)
+		{
+			const Reference<Block> block = { i };
+			const std::vector<Value>& instructions = function.GetBlock(block).Instructions;
+			if (!function.GetTerminator(block).IsValid())
+				report("the block doesn't end in a terminator", block, {});
+
+			bool phis = true;
+			for (uint32_t j = 0; j < instructions.size(); j++)
+			{
+				const Value value = instructions[j];
+				if (value.Index >= function.InstructionCount() || positions[value.Index] != s_NotPlaced)
+				{
+					report("an instruction is invalid or in multiple places", block, {});
+					continue;
+				}
+				positions[value.Index] = j;
+
+				const Instruction& instruction = function.Get(value);
+				if (instruction.Parent != block)
+					report("the instruction has the wrong parent", block, value);
+				if (IsTerminator(instruction.Op) && j + 1 != instructions.size())
+					report("a terminator is in the middle of the block", block, value);
+				if (instruction.Op == Opcode::Phi && !phis)
+					report("a phi comes after other instructions", block, value);
+
+				phis &= (instruction.Op == Opcode::Phi);
+			}
+
+			for (const Reference<Block> successor : function.GetSuccessors(block))
+			{
+				if (successor.Index >= function.BlockCount())
+					report("a target is invalid", block, function.GetTerminator(block));
+				else
+					edges[successor.Index].push_back(i);
+			}
+		}
+
+		// Note: The order of the predecessors is free, so they're compared sorted.
+		for (uint32_t i = 0; i < function.BlockCount(); i++)
+		{
+			std::vector<uint32_t> predecessors = { };
+			for (const Reference<Block> predecessor : function.GetBlock({ i }).Predecessors)
+				predecessors.push_back(predecessor.Index);
+
+			std::sort(predecessors.begin(), predecessors.end());
+			std::sort(edges[i].begin(), edges[i].end());
+			if (predecessors != edges[i])
+				report("the predecessors don't match the terminators", { i }, {});
+		}
+
+		if (!valid)
+			return false;
+
+		/////////////////////////////////////////////////////////////////
+		// Operands
+		/////////////////////////////////////////////////////////////////
+		const DominatorTree dominators(function);
+		for (uint32_t i = 0; i < function.BlockCount(); i++)
+		{
+			const Reference<Block> block = { i };
+			const std::vector<Reference<Block>>& predecessors = function.GetBlock(block).Predecessors;
+
+			for (const Value value : function.GetBlock(block).Instructions)
+			{
+				const Instruction& instruction = function.Get(value);
+				const std::span<const Value> operands = function.GetOperands(value);
+
+				if (instruction.Op == Opcode::Constant && instruction.Constant.Type != instruction.Type)
+					report("the constant has a different type", block, value);
+				if (IsComparison(instruction.Op) && instruction.Type != ValueType::Bool)
+					report("a comparison doesn't result in a bool", block, value);
+				if (instruction.Op == Opcode::Phi && operands.size() != predecessors.size())
+					report("the phi doesn't have an operand for every predecessor", block, value);
+
+				const ValueType operandType = GetOperandType(function, instruction);
+				for (size_t j = 0; j < operands.size(); j++)
+				{
+					const Value operand = operands[j];
+					if (!operand.IsValid() || operand.Index >= function.InstructionCount() || positions[operand.Index] == s_NotPlaced)
+					{
+						report("an operand is invalid", block, value);
+						continue;
+					}
+
+					const Instruction& definition = function.Get(operand);
+					if (definition.Type == ValueType::None)
+						report("an operand has no value", block, value);
+					else if (operandType != ValueType::None && definition.Type != operandType)
+						report("an operand has the wrong type", block, value);
+
+					// Note: The operands of a phi are used at the end of the matching predecessor.
+					if (instruction.Op == Opcode::Phi)
+					{
+						if (j < predecessors.size() && dominators.IsReachable(predecessors[j]) && !dominators.Dominates(definition.Parent, predecessors[j]))
+							report("an operand doesn't dominate the predecessor it comes from", block, value);
+					}
+					else if (dominators.IsReachable(block))
+					{
+						const bool dominates = (definition.Parent == block ? positions[operand.Index] < positions[value.Index] : dominators.Dominates(definition.Parent, block));
+						if (!dominates)
+							report("an operand doesn't dominate its use", block, value);
+					}
+				}
+			}
+		}
+
+		return valid;
+	}
+
+	bool Verify(const Module& module)
+	{
+		bool valid = true;
+		for (const Function& function : module.Functions)
+			valid &= Verify(function);
+
+		return valid;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Dynamite/IR/IR.hpp"
+
+namespace Dynamite::IR
+{
+
+	// Checks that the function is well formed and in SSA form: every block ends in exactly one
+	// terminator, the predecessors match the terminators, phis come first & have an operand
+	// for every predecessor, the operands have the right types and every use is dominated by
+	// its definition. Returns false & logs every problem if it isn't.
+	bool Verify(const Function& function);
+	bool Verify(const Module& module);
+
+}
\ No newline at end of file
@@ -0,0 +1,489 @@
+#include "dypch.h"
+#include "ConstantFolder.hpp"
+
+#include "Dynamite/Core/Logging.hpp"
+
+#include "Dynamite/Compiler/CompilerSuite.hpp"
+
+#include <Pulse/Core/Defines.hpp>
+
+namespace Dynamite
+{
+
+	namespace
+	{
+		static Node::LiteralTerm::Type GetLiteralType(ValueType type)
+		{
+			if (type == ValueType::Bool)
+				return Node::LiteralTerm::Type::Bool;
+			if (type == ValueType::Char)
+				return Node::LiteralTerm::Type::Char;
+			if (ValueTypeIsFloat(type))
+				return Node::LiteralTerm::Type::Float;
+
+			return Node::LiteralTerm::Type::Integer;
+		}
+
+		// Returns the location of the leftmost term of an expression.
+		static SourceLocation GetLocation(const Node::Program& program, Node::Reference<Node::Expression> expr)
+		{
+			while (expr.IsValid())
+			{
+				switch (program.GetKind(expr))
+				{
+				case Node::Expression::Kind::Literal:		return program.GetLiteral(expr).Location;
+				case Node::Expression::Kind::Identifier:	return program.GetIdentifier(expr).Location;
+				case Node::Expression::Kind::Binary:
+				{
+					const Node::BinaryExpr& binary = program.GetBinary(expr);
+					expr = (binary.LHS.IsValid() ? binary.LHS : binary.RHS);
+					break;
+				}
+
+				default:
+					return {};
+				}
+			}
+
+			return {};
+		}
+
+		template<typename T>
+		static ConstantValue EvaluateFloat(Node::BinaryExpr::Type op, ValueType type, T lhs, T rhs)
+		{
+			ConstantValue result = {};
+			result.Type = type;
+
+			switch (op)
+			{
+			case Node::BinaryExpr::Type::Addition:			result.Float = static_cast<double>(lhs + rhs); return result;
+			case Node::BinaryExpr::Type::Subtraction:		result.Float = static_cast<double>(lhs - rhs); return result;
+			case Node::BinaryExpr::Type::Multiplication:	result.Float = static_cast<double>(lhs * rhs); return result;
+			case Node::BinaryExpr::Type::Division:			result.Float = static_cast<double>(lhs / rhs); return result;
+
+			default:
+				break;
+			}
+
+			// Note: Comparisons with NaN are false, only != is true.
+			result.Type = ValueType::Bool;
+			switch (op)
+			{
+			case Node::BinaryExpr::Type::Equal:				result.Bool = (lhs == rhs); return result;
+			case Node::BinaryExpr::Type::NotEqual:			result.Bool = (lhs != rhs); return result;
+			case Node::BinaryExpr::Type::Less:				result.Bool = (lhs < rhs); return result;
+			case Node::BinaryExpr::Type::Greater:			result.Bool = (lhs > rhs); return result;
+			case Node::BinaryExpr::Type::LessEqual:			result.Bool = (lhs <= rhs); return result;
+			case Node::BinaryExpr::Type::GreaterEqual:		result.Bool = (lhs >= rhs); return result;
+
+			default:
+				break;
+			}
+
+			return {};
+		}
+
+		// Note: Operates on the extended bits, like the generated code. Bitwise operators on floats work on their bits.
+		static ConstantValue EvaluateBits(Node::BinaryExpr::Type op, ValueType type, uint64_t lhs, uint64_t rhs)
+		{
+			const bool isSigned = ValueTypeIsSigned(type);
+			const int64_t signedLhs = static_cast<int64_t>(lhs);
+			const int64_t signedRhs = static_cast<int64_t>(rhs);
+
+			switch (op)
+			{
+			case Node::BinaryExpr::Type::Addition:			return GetConstantFromBits(type, lhs + rhs);
+			case Node::BinaryExpr::Type::Subtraction:		return GetConstantFromBits(type, lhs - rhs);
+			case Node::BinaryExpr::Type::Multiplication:	return GetConstantFromBits(type, lhs * rhs);
+			case Node::BinaryExpr::Type::Division:
+			{
+				// Note: Dividing by 0 (or the smallest i64 by -1) traps, which is left to happen at runtime.
+				if (rhs == 0 || (isSigned && signedLhs == Pulse::Numeric::Min<int64_t>() && signedRhs == -1))
+					return {};
+
+				return GetConstantFromBits(type, (isSigned ? static_cast<uint64_t>(signedLhs / signedRhs) : lhs / rhs));
+			}
+
+			case Node::BinaryExpr::Type::Or:
+			case Node::BinaryExpr::Type::LogicalOr:			return GetConstantFromBits(type, lhs | rhs);
+			case Node::BinaryExpr::Type::And:
+			case Node::BinaryExpr::Type::LogicalAnd:		return GetConstantFromBits(type, lhs & rhs);
+			case Node::BinaryExpr::Type::Xor:				return GetConstantFromBits(type, lhs ^ rhs);
+
+			case Node::BinaryExpr::Type::Equal:				return GetConstantFromBits(ValueType::Bool, lhs == rhs);
+			case Node::BinaryExpr::Type::NotEqual:			return GetConstantFromBits(ValueType::Bool, lhs != rhs);
+			case Node::BinaryExpr::Type::Less:				return GetConstantFromBits(ValueType::Bool, (isSigned ? signedLhs < signedRhs : lhs < rhs));
+			case Node::BinaryExpr::Type::Greater:			return GetConstantFromBits(ValueType::Bool, (isSigned ? signedLhs > signedRhs : lhs > rhs));
+			case Node::BinaryExpr::Type::LessEqual:			return GetConstantFromBits(ValueType::Bool, (isSigned ? signedLhs <= signedRhs : lhs <= rhs));
+			case Node::BinaryExpr::Type::GreaterEqual:		return GetConstantFromBits(ValueType::Bool, (isSigned ? signedLhs >= signedRhs : lhs >= rhs));
+
+			default:
+				break;
+			}
+
+			return {};
+		}
+
+		// Returns the value of a binary expression of type, ValueType::None if it can't be computed.
+		// Note: The operands are converted the same way as when lowering.
+		static ConstantValue Evaluate(Node::BinaryExpr::Type op, ValueType type, const ConstantValue& lhs, const ConstantValue& rhs)
+		{
+			const bool logical = (op == Node::BinaryExpr::Type::LogicalAnd || op == Node::BinaryExpr::Type::LogicalOr);
+			const bool bitwise = (logical || op == Node::BinaryExpr::Type::Or || op == Node::BinaryExpr::Type::And || op == Node::BinaryExpr::Type::Xor);
+
+			ValueType operandType = type;
+			if (logical)
+				operandType = ValueType::Bool;
+			else if (Node::GetBinaryOperator(op).Comparison)
+				operandType = ValueTypePromote(lhs.Type, rhs.Type);
+
+			const std::optional<ConstantValue> left = ValueTypeConvert(operandType, lhs);
+			const std::optional<ConstantValue> right = ValueTypeConvert(operandType, rhs);
+			if (!left.has_value() || !right.has_value())
+				return {};
+
+			if (ValueTypeIsFloat(operandType) && !bitwise)
+			{
+				if (operandType == ValueType::Float32)
+					return EvaluateFloat(op, operandType, static_cast<float>(left.value().Float), static_cast<float>(right.value().Float));
+
+				return EvaluateFloat(op, operandType, left.value().Float, right.value().Float);
+			}
+
+			return EvaluateBits(op, operandType, GetConstantBits(left.value()), GetConstantBits(right.value()));
+		}
+	}
+
+	ConstantFolder::ConstantFolder(Node::Program& program)
+		: Node::Rewriter<ConstantFolder>(program)
+	{
+	}
+
+	size_t ConstantFolder::Fold()
+	{
+		m_Bodies.push_back({});
+		Walk();
+
+		const Body body = m_Bodies.back();
+		m_Bodies.pop_back();
+
+		if (body.Cut != Body::NoCut)
+		{
+			m_RemovedStatements += GetProgram().GetStatements().Size() - body.Cut;
+			GetProgram().TruncateStatements(body.Cut);
+		}
+
+		return m_Folded;
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// Hooks
+	/////////////////////////////////////////////////////////////////
+	Node::VisitResult ConstantFolder::PreStatement(Node::Reference<Node::Statement> statement)
+	{
+		Body& body = m_Bodies.back();
+		if (!m_Reachable && body.Cut == Body::NoCut)
+			body.Cut = body.Count;
+		body.Count++;
+
+		switch (GetProgram().GetKind(statement))
+		{
+		case Node::Statement::Kind::Variable:
+		{
+			// Note: Like when lowering the variable is in scope in its own expression, it's 0 there.
+			const Node::VariableStatement& variable = GetProgram().GetVariable(statement);
+			m_Variables.Push(variable.Symbol, m_Values.Add((variable.Type == ValueType::String) ? ConstantValue() : GetConstantFromBits(variable.Type, 0)));
+			m_Types.push_back(variable.Type);
+			break;
+		}
+		case Node::Statement::Kind::If:
+		{
+			const Node::IfStatement& ifStatement = GetProgram().GetIf(statement);
+			m_Conditions.push_back({ statement, ifStatement.ExprObj, ifStatement.Scope });
+
+			Condition& condition = m_Conditions.back();
+			condition.Reachable = m_Reachable;
+			condition.FirstArm = m_Arms.size();
+
+			m_Values.BeginIf();
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		return Node::VisitResult::Continue;
+	}
+
+	Node::VisitResult ConstantFolder::PostStatement(Node::Reference<Node::Statement> statement)
+	{
+		switch (GetProgram().GetKind(statement))
+		{
+		case Node::Statement::Kind::Variable:
+		{
+			const Node::VariableStatement& variable = GetProgram().GetVariable(statement);
+			m_Values[*m_Variables.Find(variable.Symbol)] = Convert(variable.ExprObj, variable.Type, variable.Location);
+			break;
+		}
+		case Node::Statement::Kind::Assignment:
+		{
+			// Note: Assignments to undeclared variables have been reported by the parser.
+			const Node::AssignmentStatement& assignment = GetProgram().GetAssignment(statement);
+			const uint32_t* slot = m_Variables.Find(assignment.Symbol);
+			if (!slot)
+				break;
+
+			m_Values.Assign(*slot, Convert(assignment.ExprObj, m_Types[*slot], assignment.Location));
+			break;
+		}
+		case Node::Statement::Kind::Exit:
+		{
+			const Node::Reference<Node::Expression> expr = GetProgram().GetExit(statement);
+			Convert(expr, ValueType::UInt8, GetLocation(GetProgram(), expr));
+
+			m_Reachable = false;
+			break;
+		}
+		case Node::Statement::Kind::If:
+		{
+			Join(statement);
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		return Node::VisitResult::Continue;
+	}
+
+	Node::VisitResult ConstantFolder::PostExpression(Node::Reference<Node::Expression> expr)
+	{
+		switch (GetProgram().GetKind(expr))
+		{
+		case Node::Expression::Kind::Identifier:
+		{
+			const uint32_t* slot = m_Variables.Find(GetProgram().GetIdentifier(expr).Symbol);
+			if (slot && m_Values[*slot].Type != ValueType::None)
+				Replace(expr, m_Values[*slot]);
+			break;
+		}
+		case Node::Expression::Kind::Binary:
+		{
+			const Node::BinaryExpr& binary = GetProgram().GetBinary(expr);
+			if (!binary.LHS.IsValid() || !binary.RHS.IsValid())
+				break;
+			if (GetProgram().GetKind(binary.LHS) != Node::Expression::Kind::Literal || GetProgram().GetKind(binary.RHS) != Node::Expression::Kind::Literal)
+				break;
+
+			const ConstantValue& lhs = GetProgram().GetLiteral(binary.LHS).Value;
+			const ConstantValue& rhs = GetProgram().GetLiteral(binary.RHS).Value;
+			const ConstantValue value = Evaluate(binary.BinaryType, GetProgram().GetType(expr), lhs, rhs);
+			if (value.Type == ValueType::None)
+				break;
+
+			// Note: The value wraps around like the generated code, which is reported if that isn't the exact value.
+			if (ValueTypeIsInteger(value.Type) && ValueTypeIsInteger(lhs.Type) && ValueTypeIsInteger(rhs.Type))
+			{
+				const ConstantValue exact = Node::EvaluateExact(binary.BinaryType, lhs, rhs);
+				const std::optional<ConstantValue> wrapped = ValueTypeConvert(value.Type, exact);
+				if (!ValueTypeFits(value.Type, exact) || GetConstantBits(wrapped.value()) != GetConstantBits(value))
+				{
+					const std::string exactStr = (exact.Type != ValueType::None ? FormatConstantValue(exact) : std::string("out of 64 bit range"));
+					CompilerSuite::Warn(GetLocation(GetProgram(), expr), "Folded expression overflows its type: {0}\n    Exact: \t\t{1}\n    Folded: \t\t{2}", ValueTypeToStr(value.Type), exactStr, FormatConstantValue(value));
+				}
+			}
+
+			Replace(expr, value);
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		return Node::VisitResult::Continue;
+	}
+
+	Node::VisitResult ConstantFolder::PreScope(Node::Reference<Node::ScopeStatement> scope)
+	{
+		if (!m_Conditions.empty() && m_Conditions.back().Scope == scope)
+			BeginArm();
+
+		m_Variables.PushScope();
+		m_Bodies.push_back({ 0, Body::NoCut, m_Reachable });
+		return Node::VisitResult::Continue;
+	}
+
+	Node::VisitResult ConstantFolder::PostScope(Node::Reference<Node::ScopeStatement> scope)
+	{
+		m_Variables.PopScope();
+
+		// Note: Scopes that can't be reached are removed as a whole.
+		const Body body = m_Bodies.back();
+		m_Bodies.pop_back();
+
+		if (body.Reachable && body.Cut != Body::NoCut)
+		{
+			m_RemovedStatements += GetProgram().GetStatements(scope).Size() - body.Cut;
+			GetProgram().Truncate(scope, body.Cut);
+		}
+
+		if (!m_Conditions.empty() && m_Conditions.back().Scope == scope)
+			EndArm();
+
+		return Node::VisitResult::Continue;
+	}
+
+	Node::VisitResult ConstantFolder::PreBranch(Node::Reference<Node::ConditionBranch> branch)
+	{
+		switch (GetProgram().GetKind(branch))
+		{
+		case Node::ConditionBranch::Kind::ElseIf:
+		{
+			const Node::ElseIfBranch& elseIf = GetProgram().GetElseIf(branch);
+			m_Conditions.back().ExprObj = elseIf.ExprObj;
+			m_Conditions.back().Scope = elseIf.Scope;
+			break;
+		}
+		case Node::ConditionBranch::Kind::Else:
+		{
+			m_Conditions.back().ExprObj = {};
+			m_Conditions.back().Scope = GetProgram().GetElse(branch);
+			break;
+		}
+
+		default:
+			break;
+		}
+
+		return Node::VisitResult::Continue;
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// Helper functions
+	/////////////////////////////////////////////////////////////////
+	void ConstantFolder::Replace(Node::Reference<Node::Expression> expr, const ConstantValue& value)
+	{
+		const Node::LiteralTerm literal = { GetLiteralType(value.Type), GetLocation(GetProgram(), expr), value };
+		GetProgram().Replace(expr, GetProgram().AddLiteral(GetProgram().GetType(expr), literal));
+
+		m_Folded++;
+	}
+
+	ConstantValue ConstantFolder::Convert(Node::Reference<Node::Expression> expr, ValueType type, SourceLocation location)
+	{
+		// Note: Strings aren't propagated, every use would be a copy of the string.
+		if (!expr.IsValid() || GetProgram().GetKind(expr) != Node::Expression::Kind::Literal || type == ValueType::String)
+			return {};
+
+		Node::LiteralTerm& literal = GetProgram().GetLiteral(expr);
+		const std::optional<ConstantValue> value = ValueTypeConvert(type, literal.Value);
+		if (!value.has_value())
+			return {};
+
+		// Note: Like the literals cast by the parser, out of range integers wrap around. Every value converts exactly to bool.
+		if (type != ValueType::Bool && !ValueTypeFits(type, literal.Value))
+			CompilerSuite::Warn(location, "Lost data while casting folded expression. From: {0}, to {1}\n    Original: \t\t{2}\n    New: \t\t{3}", ValueTypeToStr(literal.Value.Type), ValueTypeToStr(type), FormatConstantValue(literal.Value), FormatConstantValue(value.value()));
+
+		literal.Value = value.value();
+		return value.value();
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// If statements
+	/////////////////////////////////////////////////////////////////
+	void ConstantFolder::BeginArm()
+	{
+		Condition& condition = m_Conditions.back();
+
+		// Note: An else branch always runs when it's reached, a branch with a condition only if it's constant.
+		bool always = !condition.ExprObj.IsValid();
+		bool never = false;
+		if (!always && GetProgram().GetKind(condition.ExprObj) == Node::Expression::Kind::Literal)
+		{
+			const std::optional<ConstantValue> value = ValueTypeConvert(ValueType::Bool, GetProgram().GetLiteral(condition.ExprObj).Value);
+			if (value.has_value())
+			{
+				always = value.value().Bool;
+				never = !always;
+			}
+		}
+
+		condition.Dead = (!condition.Reachable || condition.Taken || never);
+		if (condition.Dead)
+		{
+			if (condition.Reachable)
+				m_RemovedBranches++;
+
+			condition.Changed = true;
+		}
+		else
+		{
+			m_Arms.push_back({ condition.ExprObj, condition.Scope, always });
+			condition.Taken = always;
+			condition.Changed = (condition.Changed || (always && condition.ExprObj.IsValid()));
+		}
+
+		m_Reachable = !condition.Dead;
+		m_Values.BeginBranch();
+	}
+
+	void ConstantFolder::EndArm()
+	{
+		const Condition& condition = m_Conditions.back();
+
+		m_Values.EndBranch(!condition.Dead && m_Reachable);
+		m_Reachable = condition.Reachable;
+	}
+
+	void ConstantFolder::Join(Node::Reference<Node::Statement> statement)
+	{
+		const Condition condition = m_Conditions.back();
+		m_Conditions.pop_back();
+
+		// Note: Without a branch that always runs, the if statement can also continue without running any.
+		if (!condition.Taken)
+			m_Values.AddPath();
+
+		// Note: A variable is only known if every path leaves the same value.
+		const size_t paths = m_Values.PathCount();
+		m_Values.EndIf([](uint32_t, std::span<const ConstantValue> values)
+		{
+			for (const ConstantValue& value : values)
+			{
+				if (value.Type != values[0].Type || GetConstantBits(value) != GetConstantBits(values[0]))
+					return ConstantValue();
+			}
+
+			return values[0];
+		});
+
+		m_Reachable = (condition.Reachable && paths != 0);
+
+		// Note: The branches that can run are chained again, the first one replaces the if statement.
+		// Unreachable if statements are removed as a whole.
+		if (condition.Reachable && condition.Changed)
+		{
+			Node::Program& program = GetProgram();
+			const std::span<const Arm> arms = { m_Arms.data() + condition.FirstArm, m_Arms.size() - condition.FirstArm };
+
+			if (arms.empty())
+				program.Replace(statement, program.AddScope(program.AddScopeBody(nullptr, 0)));
+			else if (arms[0].Always)
+				program.Replace(statement, program.AddScope(arms[0].Scope));
+			else
+			{
+				Node::Reference<Node::ConditionBranch> next = {};
+				for (size_t i = arms.size() - 1; i > 0; i--)
+					next = (arms[i].Always ? program.AddElse(arms[i].Scope) : program.AddElseIf({ arms[i].ExprObj, arms[i].Scope, next }));
+
+				program.Replace(statement, program.AddIf({ arms[0].ExprObj, arms[0].Scope, next }));
+			}
+		}
+
+		m_Arms.resize(condition.FirstArm);
+	}
+
+}
\ No newline at end of file
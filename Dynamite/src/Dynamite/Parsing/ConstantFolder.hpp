@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Dynamite/Core/SymbolTable.hpp"
+#include "Dynamite/Core/BranchValues.hpp"
+#include "Dynamite/Core/SourceLocation.hpp"
+
+#include "Dynamite/Parsing/Nodes.hpp"
+#include "Dynamite/Parsing/Visitor.hpp"
+#include "Dynamite/Parsing/Variables.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// Constant folding
+	/////////////////////////////////////////////////////////////////
+	// Note: Replaces binary expressions of constants with their value and variables
+	// whose value is known with that value. Values are computed like the generated code
+	// would, so integers wrap around at the size of their type. A folded integer that
+	// isn't its exact value is reported, as are folded values that don't fit in the type
+	// they are assigned to. Values are known through straight-line code & scopes, a
+	// variable that is assigned in a branch of an if statement is only known after it
+	// if every branch that continues leaves the same value.
+	// Branches with a constant condition are folded as well, a branch that can't run is
+	// removed and one that always runs becomes the else branch. So are the statements
+	// that come after an exit(), since they can't be reached.
+	class ConstantFolder : public Node::Rewriter<ConstantFolder>
+	{
+	public:
+		ConstantFolder(Node::Program& program);
+		~ConstantFolder() = default;
+
+		// Returns the amount of expressions that were folded.
+		size_t Fold();
+
+		inline size_t RemovedBranchCount() const { return m_RemovedBranches; }
+		inline size_t RemovedStatementCount() const { return m_RemovedStatements; }
+
+	public:
+		// Hooks
+		Node::VisitResult PreStatement(Node::Reference<Node::Statement> statement);
+		Node::VisitResult PostStatement(Node::Reference<Node::Statement> statement);
+		Node::VisitResult PostExpression(Node::Reference<Node::Expression> expr);
+		Node::VisitResult PreScope(Node::Reference<Node::ScopeStatement> scope);
+		Node::VisitResult PostScope(Node::Reference<Node::ScopeStatement> scope);
+		Node::VisitResult PreBranch(Node::Reference<Node::ConditionBranch> branch);
+
+	private:
+		void Replace(Node::Reference<Node::Expression> expr, const ConstantValue& value);
+
+		// Converts the value of a folded expression to type, like the generated code would. Conversions
+		// that lose data are reported at location. Note: Returns ValueType::None if it isn't constant.
+		ConstantValue Convert(Node::Reference<Node::Expression> expr, ValueType type, SourceLocation location);
+
+		// Note: The steps of folding an if statement.
+		void BeginArm();
+		void EndArm();
+		void Join(Node::Reference<Node::Statement> statement);
+
+	private:
+		// Note: Every variable has a slot with its value, ValueType::None if it isn't known.
+		// The values go through if statements the same way as when lowering.
+		ScopedSymbolTable<uint32_t> m_Variables = { };
+		BranchValues<ConstantValue> m_Values = { };
+		std::vector<ValueType> m_Types = { };
+
+		// Note: False after an exit(), or in a branch that can't run. Unreachable code is
+		// still folded, so the errors in lazy bodies are reported, but it is removed.
+		bool m_Reachable = true;
+
+		// Note: The statements of the scopes that are being folded, statements from Cut on can't be reached.
+		struct Body
+		{
+		public:
+			constexpr static const uint32_t NoCut = static_cast<uint32_t>(-1);
+
+			uint32_t Count = 0; // The statements that have been visited
+			uint32_t Cut = NoCut;
+			bool Reachable = true;
+		};
+
+		std::vector<Body> m_Bodies = { };
+
+		// Note: A branch that can run, if Always it runs when it's reached & the branches after it can't run.
+		struct Arm
+		{
+		public:
+			Node::Reference<Node::Expression> ExprObj = {};
+			Node::Reference<Node::ScopeStatement> Scope = {};
+			bool Always = false;
+		};
+
+		struct Condition
+		{
+		public:
+			Node::Reference<Node::Statement> Statement = {};
+			// Note: Of the branch that is being folded or comes next, ExprObj is invalid for else.
+			Node::Reference<Node::Expression> ExprObj = {};
+			Node::Reference<Node::ScopeStatement> Scope = {};
+
+			bool Reachable = true; // If the if statement can be reached
+			bool Dead = false; // If the current branch can't run
+			bool Taken = false; // If a previous branch always runs
+			bool Changed = false; // If a branch was removed or always runs
+
+			size_t FirstArm = 0; // Into m_Arms
+		};
+
+		std::vector<Arm> m_Arms = { };
+		std::vector<Condition> m_Conditions = { };
+
+		size_t m_Folded = 0;
+		size_t m_RemovedBranches = 0;
+		size_t m_RemovedStatements = 0;
+	};
+
+}
\ No newline at end of file
@@ -8,219 +8,714 @@
 #undef FMT_VERSION
 #include <Pulse/Enum/Enum.hpp>
 
-#include <Pulse/Types/TypeUtils.hpp>
-
 namespace Dynamite::Node
 {
 
-	// This can change based on the Reference<T> type.
-	// Currently it's a pointer, so the _DEREF 'operator' should be nothing
-	#define _DEREF 
-
 	namespace
 	{
-		constexpr static const size_t s_MaxSize = 2ull * (1024 * 1024); // 2 MB
-		static Pulse::Memory::DynamicArenaAllocator s_Allocator(s_MaxSize);
+		thread_local static Arena* s_Arena = nullptr;
+
+		template<typename T>
+		inline Reference<T> Offset(Reference<T> reference, uint32_t base)
+		{
+			return (reference.IsValid() ? Reference<T>{ reference.Index + base } : reference);
+		}
+
+		std::string FormatIdentifier(const Program& program, SymbolId symbol)
+		{
+			return FormatToken(Token(TokenType::Identifier, program.GetSymbols().GetName(symbol)));
+		}
+
+		// Note: An integer as its sign & magnitude, so every signed and unsigned 64 bit value fits.
+		struct Exact
+		{
+		public:
+			bool Negative = false;
+			uint64_t Magnitude = 0;
+		};
+
+		Exact GetExact(const ConstantValue& value)
+		{
+			if (ValueTypeIsSigned(value.Type) && value.Int < 0)
+				return { true, 0 - static_cast<uint64_t>(value.Int) };
+
+			return { false, GetConstantBits(value) };
+		}
+
+		/////////////////////////////////////////////////////////////////
+		// Formatting
+		/////////////////////////////////////////////////////////////////
+		// Note: Nodes are formatted with an explicit stack of work instead of
+		// recursion, so deeply nested trees can't overflow the stack. The text
+		// is written in order to a single string, the work on the stack is
+		// what comes after the node that is currently being written.
+		struct FormatWork
+		{
+		public:
+			enum class Kind : uint8_t { Text, Character, Expression, Statement, Branch, Scope };
+		public:
+			Kind WorkKind = Kind::Text;
+			uint32_t Index = 0; // Of the node
+			std::string_view Text = {};
+			char Character = '\0';
+		};
+
+		void Format(const Program& program, FormatWork root, std::string& str)
+		{
+			std::vector<FormatWork> stack = { root };
+			while (!stack.empty())
+			{
+				const FormatWork work = stack.back();
+				stack.pop_back();
+
+				switch (work.WorkKind)
+				{
+				case FormatWork::Kind::Text:
+					str += work.Text;
+					break;
+				case FormatWork::Kind::Character:
+					str += work.Character;
+					break;
+
+				case FormatWork::Kind::Expression:
+				{
+					const Reference<Expression> expr = { work.Index };
+					if (!expr.IsValid())
+					{
+						str += "Undefined Expression Data";
+						break;
+					}
+
+					switch (program.GetKind(expr))
+					{
+					case Expression::Kind::Literal:
+					{
+						const LiteralTerm& literal = program.GetLiteral(expr);
+						str += Pulse::Text::Format("TokenType::{0}, Value = {1}", Pulse::Enum::Name(static_cast<TokenType>(literal.LiteralType)), FormatConstantValue(literal.Value));
+						break;
+					}
+					case Expression::Kind::Identifier:
+						str += FormatIdentifier(program, program.GetIdentifier(expr).Symbol);
+						break;
+					case Expression::Kind::Binary:
+					{
+						// "LHS: {0}, '{1}' RHS: {2}"
+						const BinaryExpr& binary = program.GetBinary(expr);
+						const BinaryOperator& operation = GetBinaryOperator(binary.BinaryType);
+
+						// Note: There are no parenthesis nodes, an operand is put in parentheses
+						// when it binds looser than this operator (the same on the side it doesn't associate to).
+						auto grouped = [&](Reference<Expression> operand, bool rhs)
+						{
+							if (!operand.IsValid() || program.GetKind(operand) != Expression::Kind::Binary)
+								return false;
+
+							const uint8_t power = GetBinaryOperator(program.GetBinary(operand).BinaryType).Power;
+							return (power < operation.Power || (power == operation.Power && rhs == (operation.Assoc == Associativity::Left)));
+						};
+						const bool groupLHS = grouped(binary.LHS, false);
+						const bool groupRHS = grouped(binary.RHS, true);
+
+						str += "LHS: ";
+						if (groupRHS)
+							stack.push_back({ .WorkKind = FormatWork::Kind::Character, .Character = ')' });
+						stack.push_back({ FormatWork::Kind::Expression, binary.RHS.Index });
+						if (groupRHS)
+							stack.push_back({ .WorkKind = FormatWork::Kind::Character, .Character = '(' });
+						stack.push_back({ .Text = "' RHS: " });
+						stack.push_back({ .Text = operation.Text });
+						stack.push_back({ .Text = ", '" });
+						if (groupLHS)
+							stack.push_back({ .WorkKind = FormatWork::Kind::Character, .Character = ')' });
+						stack.push_back({ FormatWork::Kind::Expression, binary.LHS.Index });
+						if (groupLHS)
+							stack.push_back({ .WorkKind = FormatWork::Kind::Character, .Character = '(' });
+						break;
+					}
+
+					default:
+						str += "Undefined Expression Data";
+						break;
+					}
+					break;
+				}
+
+				case FormatWork::Kind::Statement:
+				{
+					const Reference<Statement> statement = { work.Index };
+					switch (program.GetKind(statement))
+					{
+					case Statement::Kind::Variable:
+					{
+						const VariableStatement& variable = program.GetVariable(statement);
+						str += Pulse::Text::Format("[Variable({0})] - {1}([", ValueTypeToStr(variable.Type), FormatIdentifier(program, variable.Symbol));
+						stack.push_back({ .Text = "])" });
+						stack.push_back({ FormatWork::Kind::Expression, variable.ExprObj.Index });
+						break;
+					}
+					case Statement::Kind::Exit:
+						str += "[Exit] - ";
+						stack.push_back({ FormatWork::Kind::Expression, program.GetExit(statement).Index });
+						break;
+					case Statement::Kind::Scope:
+						stack.push_back({ FormatWork::Kind::Scope, program.GetScope(statement).Index });
+						break;
+					case Statement::Kind::If:
+					{
+						const IfStatement& ifStatement = program.GetIf(statement);
+						str += "\nif (";
+						if (ifStatement.Next.IsValid())
+							stack.push_back({ FormatWork::Kind::Branch, ifStatement.Next.Index });
+						stack.push_back({ FormatWork::Kind::Scope, ifStatement.Scope.Index });
+						stack.push_back({ .Text = ")" });
+						stack.push_back({ FormatWork::Kind::Expression, ifStatement.ExprObj.Index });
+						break;
+					}
+					case Statement::Kind::Assignment:
+					{
+						const AssignmentStatement& assignment = program.GetAssignment(statement);
+						str += Pulse::Text::Format("[Assignment] - {0}([", FormatIdentifier(program, assignment.Symbol));
+						stack.push_back({ .Text = "])" });
+						stack.push_back({ FormatWork::Kind::Expression, assignment.ExprObj.Index });
+						break;
+					}
+
+					default:
+						str += "Undefined Statement Data";
+						break;
+					}
+					break;
+				}
+
+				case FormatWork::Kind::Branch:
+				{
+					const Reference<ConditionBranch> branch = { work.Index };
+					switch (program.GetKind(branch))
+					{
+					case ConditionBranch::Kind::ElseIf:
+					{
+						const ElseIfBranch& elseIf = program.GetElseIf(branch);
+						str += "\nelse if (";
+						if (elseIf.Next.IsValid())
+							stack.push_back({ FormatWork::Kind::Branch, elseIf.Next.Index });
+						stack.push_back({ FormatWork::Kind::Scope, elseIf.Scope.Index });
+						stack.push_back({ .Text = ")" });
+						stack.push_back({ FormatWork::Kind::Expression, elseIf.ExprObj.Index });
+						break;
+					}
+					case ConditionBranch::Kind::Else:
+						str += "\nelse";
+						stack.push_back({ FormatWork::Kind::Scope, program.GetElse(branch).Index });
+						break;
+
+					default:
+						str += "Undefined Condition Branch";
+						break;
+					}
+					break;
+				}
+
+				case FormatWork::Kind::Scope:
+				{
+					const StatementRange statements = program.GetStatements({ work.Index });
+					str += "\n{{\n";
+					stack.push_back({ .Text = "\n}}" });
+					for (size_t i = statements.Size(); i > 0; i--)
+					{
+						stack.push_back({ FormatWork::Kind::Statement, statements[i - 1].Index });
+						stack.push_back({ .Text = "\n\t" });
+					}
+					break;
+				}
+				}
+			}
+		}
 	}
 
 	/////////////////////////////////////////////////////////////////
-	// Constructors
+	// Program
 	/////////////////////////////////////////////////////////////////
-	LiteralTerm::LiteralTerm(Type literalType, const Token& token) : LiteralType(literalType), TokenObj(token) {}
-	
-	IdentifierTerm::IdentifierTerm(const Token& token) : TokenObj(token) {}
+	Program::Program(Arena& arena, const Interner& symbols)
+		: m_Symbols(&symbols), 
+		m_ExprKinds(arena), m_ExprTypes(arena), m_ExprData(arena), m_Literals(arena), m_Identifiers(arena), m_Binaries(arena),
+		m_StatementKinds(arena), m_StatementData(arena), m_Variables(arena), m_Ifs(arena), m_Assignments(arena), m_Scopes(arena), m_ScopeStatements(arena),
+		m_BranchKinds(arena), m_BranchData(arena), m_ElseIfs(arena)
+	{
+	}
 
-	ParenthesisTerm::ParenthesisTerm(Reference<Expression> expr) : ExprObj(expr) {}
+	Reference<Expression> Program::AddLiteral(ValueType type, const LiteralTerm& literal)
+	{
+		m_ExprKinds.Push(Expression::Kind::Literal);
+		m_ExprTypes.Push(type);
+		return { m_ExprData.Push(m_Literals.Push(literal)) };
+	}
 
-	TermExpr::TermExpr(Variant<Reference<LiteralTerm>, Reference<IdentifierTerm>, Reference<ParenthesisTerm>> term) : TermObj(term) {}
+	Reference<Expression> Program::AddIdentifier(ValueType type, const IdentifierTerm& identifier)
+	{
+		m_ExprKinds.Push(Expression::Kind::Identifier);
+		m_ExprTypes.Push(type);
+		return { m_ExprData.Push(m_Identifiers.Push(identifier)) };
+	}
 
-	BinaryExpr::BinaryExpr(Type binaryType, Reference<Expression> lhs, Reference<Expression> rhs) : BinaryType(binaryType), LHS(lhs), RHS(rhs) {}
+	Reference<Expression> Program::AddBinary(ValueType type, const BinaryExpr& binary)
+	{
+		m_ExprKinds.Push(Expression::Kind::Binary);
+		m_ExprTypes.Push(type);
+		return { m_ExprData.Push(m_Binaries.Push(binary)) };
+	}
 
-	Expression::Expression(ValueType type, Variant<Reference<TermExpr>, Reference<BinaryExpr>> expr) : Type(type), ExprObj(expr) {}
-	
+	Reference<Statement> Program::AddVariable(const VariableStatement& variable)
+	{
+		m_StatementKinds.Push(Statement::Kind::Variable);
+		return { m_StatementData.Push(m_Variables.Push(variable)) };
+	}
 
+	Reference<Statement> Program::AddExit(Reference<Expression> expr)
+	{
+		m_StatementKinds.Push(Statement::Kind::Exit);
+		return { m_StatementData.Push(expr.Index) };
+	}
 
-	ElseIfBranch::ElseIfBranch(Reference<Expression> expr, Reference<ScopeStatement> scope, std::optional<Reference<ConditionBranch>> next) : ExprObj(expr), Scope(scope), Next(next) {}
+	Reference<Statement> Program::AddScope(Reference<ScopeStatement> scope)
+	{
+		m_StatementKinds.Push(Statement::Kind::Scope);
+		return { m_StatementData.Push(scope.Index) };
+	}
 
-	ElseBranch::ElseBranch(Reference<ScopeStatement> scope) : Scope(scope) {}
+	Reference<Statement> Program::AddIf(const IfStatement& ifStatement)
+	{
+		m_StatementKinds.Push(Statement::Kind::If);
+		return { m_StatementData.Push(m_Ifs.Push(ifStatement)) };
+	}
 
-	ConditionBranch::ConditionBranch(Variant<Reference<ElseIfBranch>, Reference<ElseBranch>> branch) : ConditionObj(branch) {}
+	Reference<Statement> Program::AddAssignment(const AssignmentStatement& assignment)
+	{
+		m_StatementKinds.Push(Statement::Kind::Assignment);
+		return { m_StatementData.Push(m_Assignments.Push(assignment)) };
+	}
 
-	IfStatement::IfStatement(Reference<Expression> expr, Reference<ScopeStatement> scope, std::optional<Reference<ConditionBranch>> next) : ExprObj(expr), Scope(scope), Next(next) {}
+	Reference<ScopeStatement> Program::AddScopeBody(const Reference<Statement>* statements, size_t count)
+	{
+		const uint32_t first = m_ScopeStatements.Size();
+		for (size_t i = 0; i < count; i++)
+			m_ScopeStatements.Push(statements[i]);
 
-	VariableStatement::VariableStatement(ValueType type, const Token& token, Reference<Expression> expr) : Type(type), TokenObj(token), ExprObj(expr) {}
+		return { m_Scopes.Push({ first, static_cast<uint32_t>(count) }) };
+	}
 
-	ExitStatement::ExitStatement(Reference<Expression> expr) : ExprObj(expr) {}
+	Reference<ScopeStatement> Program::AddLazyScope(uint32_t index)
+	{
+		return { m_Scopes.Push({ index, ScopeStatement::LazyCount }) };
+	}
 
-	ScopeStatement::ScopeStatement(const std::vector<Reference<Statement>>& statements) : Statements(statements) {}
+	Reference<ConditionBranch> Program::AddElseIf(const ElseIfBranch& branch)
+	{
+		m_BranchKinds.Push(ConditionBranch::Kind::ElseIf);
+		return { m_BranchData.Push(m_ElseIfs.Push(branch)) };
+	}
 
-	AssignmentStatement::AssignmentStatement(const Token& token, Reference<Expression> expr) : TokenObj(token), ExprObj(expr) {}
+	Reference<ConditionBranch> Program::AddElse(Reference<ScopeStatement> scope)
+	{
+		m_BranchKinds.Push(ConditionBranch::Kind::Else);
+		return { m_BranchData.Push(scope.Index) };
+	}
 
-	Statement::Statement(Variant<Reference<VariableStatement>, Reference<ExitStatement>, Reference<ScopeStatement>, Reference<IfStatement>, Reference<AssignmentStatement>> statement) : StatementObj(statement) {}
+	void Program::Replace(Reference<Expression> expr, Reference<Expression> replacement)
+	{
+		m_ExprKinds[expr.Index] = m_ExprKinds[replacement.Index];
+		m_ExprTypes[expr.Index] = m_ExprTypes[replacement.Index];
+		m_ExprData[expr.Index] = m_ExprData[replacement.Index];
+	}
 
-	/////////////////////////////////////////////////////////////////
-	// Custom allocator functions
-	/////////////////////////////////////////////////////////////////
-	Reference<LiteralTerm> LiteralTerm::New(Type literalType, const Token& token) { return _DEREF s_Allocator.Construct<LiteralTerm>(literalType, token); }
+	void Program::Replace(Reference<Statement> statement, Reference<Statement> replacement)
+	{
+		m_StatementKinds[statement.Index] = m_StatementKinds[replacement.Index];
+		m_StatementData[statement.Index] = m_StatementData[replacement.Index];
+	}
 
-	Reference<IdentifierTerm> IdentifierTerm::New(const Token& token) { return _DEREF s_Allocator.Construct<IdentifierTerm>(token); }
+	void Program::Replace(Reference<ConditionBranch> branch, Reference<ConditionBranch> replacement)
+	{
+		m_BranchKinds[branch.Index] = m_BranchKinds[replacement.Index];
+		m_BranchData[branch.Index] = m_BranchData[replacement.Index];
+	}
 
-	Reference<ParenthesisTerm> ParenthesisTerm::New(Reference<Expression> expr) { return _DEREF s_Allocator.Construct<ParenthesisTerm>(expr); }
+	void Program::Truncate(Reference<ScopeStatement> scope, size_t count)
+	{
+		m_Scopes[scope.Index].Count = std::min(m_Scopes[scope.Index].Count, static_cast<uint32_t>(count));
+	}
 
-	Reference<TermExpr> TermExpr::New(Variant<Reference<LiteralTerm>, Reference<IdentifierTerm>, Reference<ParenthesisTerm>> term) { return _DEREF s_Allocator.Construct<TermExpr>(term); }
+	void Program::SetStatements(const Reference<Statement>* statements, size_t count)
+	{
+		m_Statements = { m_ScopeStatements.Size(), static_cast<uint32_t>(count) };
+		for (size_t i = 0; i < count; i++)
+			m_ScopeStatements.Push(statements[i]);
+	}
 
-	Reference<BinaryExpr> BinaryExpr::New(Type binaryType, Reference<Expression> lhs, Reference<Expression> rhs) { return _DEREF s_Allocator.Construct<BinaryExpr>(binaryType, lhs, rhs); }
+	void Program::TruncateStatements(size_t count)
+	{
+		m_Statements.Count = std::min(m_Statements.Count, static_cast<uint32_t>(count));
+	}
 
-	Reference<Expression> Expression::New(ValueType type, Variant<Reference<TermExpr>, Reference<BinaryExpr>> expr) { return _DEREF s_Allocator.Construct<Expression>(type, expr); }
+	void Program::PrepareMerge(const Program* programs, size_t count)
+	{
+		const Sizes sizes = GetMergeBase(programs, count);
+
+		m_ExprKinds.Resize(sizes.Expressions);
+		m_ExprTypes.Resize(sizes.Expressions);
+		m_ExprData.Resize(sizes.Expressions);
+		m_Literals.Resize(sizes.Literals);
+		m_Identifiers.Resize(sizes.Identifiers);
+		m_Binaries.Resize(sizes.Binaries);
+
+		m_StatementKinds.Resize(sizes.Statements);
+		m_StatementData.Resize(sizes.Statements);
+		m_Variables.Resize(sizes.Variables);
+		m_Ifs.Resize(sizes.Ifs);
+		m_Assignments.Resize(sizes.Assignments);
+
+		// Note: The top level statements have to be contiguous, so they are stored after all nodes.
+		m_Scopes.Resize(sizes.Scopes);
+		m_ScopeStatements.Resize(sizes.ScopeStatements + sizes.TopLevel);
+		m_Statements = { sizes.ScopeStatements, sizes.TopLevel };
+
+		m_BranchKinds.Resize(sizes.Branches);
+		m_BranchData.Resize(sizes.Branches);
+		m_ElseIfs.Resize(sizes.ElseIfs);
+	}
 
+	void Program::Merge(const Program* programs, size_t index)
+	{
+		const Program& program = programs[index];
+		const Sizes sizes = program.GetSizes();
 
+		// Note: All references of program are offset by the nodes of the programs before it.
+		const Sizes base = GetMergeBase(programs, index);
 
-	Reference<ElseIfBranch> ElseIfBranch::New(Reference<Expression> expr, Reference<ScopeStatement> scope, std::optional<Reference<ConditionBranch>> next) { return _DEREF s_Allocator.Construct<ElseIfBranch>(expr, scope, next); }
+		// Expressions
+		for (uint32_t i = 0; i < sizes.Expressions; i++)
+		{
+			const Expression::Kind kind = program.m_ExprKinds[i];
+			const uint32_t data = program.m_ExprData[i];
 
-	Reference<ElseBranch> ElseBranch::New(Reference<ScopeStatement> scope) { return _DEREF s_Allocator.Construct<ElseBranch>(scope); }
+			m_ExprKinds[base.Expressions + i] = kind;
+			m_ExprTypes[base.Expressions + i] = program.m_ExprTypes[i];
 
-	Reference<ConditionBranch> ConditionBranch::New(Variant<Reference<ElseIfBranch>, Reference<ElseBranch>> branch) { return _DEREF s_Allocator.Construct<ConditionBranch>(branch); }
+			uint32_t& target = m_ExprData[base.Expressions + i];
+			switch (kind)
+			{
+			case Expression::Kind::Literal:		target = data + base.Literals; break;
+			case Expression::Kind::Identifier:	target = data + base.Identifiers; break;
+			case Expression::Kind::Binary:		target = data + base.Binaries; break;
 
-	Reference<IfStatement> IfStatement::New(Reference<Expression> expr, Reference<ScopeStatement> scope, std::optional<Reference<ConditionBranch>> next) { return _DEREF s_Allocator.Construct<IfStatement>(expr, scope, next); }
+			default:
+				target = data;
+				break;
+			}
+		}
 
-	Reference<VariableStatement> VariableStatement::New(ValueType type, const Token& token, Reference<Expression> expr) { return _DEREF s_Allocator.Construct<VariableStatement>(type, token, expr); }
+		for (uint32_t i = 0; i < sizes.Literals; i++)
+			m_Literals[base.Literals + i] = program.m_Literals[i];
+		for (uint32_t i = 0; i < sizes.Identifiers; i++)
+			m_Identifiers[base.Identifiers + i] = program.m_Identifiers[i];
+		for (uint32_t i = 0; i < sizes.Binaries; i++)
+		{
+			const BinaryExpr& binary = program.m_Binaries[i];
+			m_Binaries[base.Binaries + i] = { binary.BinaryType, Offset(binary.LHS, base.Expressions), Offset(binary.RHS, base.Expressions) };
+		}
 
-	Reference<ExitStatement> ExitStatement::New(Reference<Expression> expr) { return _DEREF s_Allocator.Construct<ExitStatement>(expr); }
+		// Statements
+		for (uint32_t i = 0; i < sizes.Statements; i++)
+		{
+			const Statement::Kind kind = program.m_StatementKinds[i];
+			const uint32_t data = program.m_StatementData[i];
 
-	Reference<ScopeStatement> ScopeStatement::New(const std::vector<Reference<Statement>>& statements) { return _DEREF s_Allocator.Construct<ScopeStatement>(statements); }
+			m_StatementKinds[base.Statements + i] = kind;
 
-	Reference<AssignmentStatement> AssignmentStatement::New(const Token& token, Reference<Expression> expr) { return _DEREF s_Allocator.Construct<AssignmentStatement>(token, expr); }
+			uint32_t& target = m_StatementData[base.Statements + i];
+			switch (kind)
+			{
+			case Statement::Kind::Variable:		target = data + base.Variables; break;
+			case Statement::Kind::Exit:			target = Offset(Reference<Expression>{ data }, base.Expressions).Index; break;
+			case Statement::Kind::Scope:		target = data + base.Scopes; break;
+			case Statement::Kind::If:			target = data + base.Ifs; break;
+			case Statement::Kind::Assignment:	target = data + base.Assignments; break;
+
+			default:
+				target = data;
+				break;
+			}
+		}
 
-	Reference<Statement> Statement::New(Variant<Reference<VariableStatement>, Reference<ExitStatement>, Reference<ScopeStatement>, Reference<IfStatement>, Reference<AssignmentStatement>> statement) { return _DEREF s_Allocator.Construct<Statement>(statement); }
+		for (uint32_t i = 0; i < sizes.Variables; i++)
+		{
+			VariableStatement variable = program.m_Variables[i];
+			variable.ExprObj = Offset(variable.ExprObj, base.Expressions);
+			m_Variables[base.Variables + i] = variable;
+		}
+		for (uint32_t i = 0; i < sizes.Ifs; i++)
+		{
+			const IfStatement& ifStatement = program.m_Ifs[i];
+			m_Ifs[base.Ifs + i] = { Offset(ifStatement.ExprObj, base.Expressions), Offset(ifStatement.Scope, base.Scopes), Offset(ifStatement.Next, base.Branches) };
+		}
+		for (uint32_t i = 0; i < sizes.Assignments; i++)
+		{
+			AssignmentStatement assignment = program.m_Assignments[i];
+			assignment.ExprObj = Offset(assignment.ExprObj, base.Expressions);
+			m_Assignments[base.Assignments + i] = assignment;
+		}
 
-	/////////////////////////////////////////////////////////////////
-	// Helper functions
-	/////////////////////////////////////////////////////////////////
-	std::optional<size_t> GetBinaryExprPrecendce(BinaryExpr::Type type)
-	{
-		switch (type)
+		for (uint32_t i = 0; i < sizes.Scopes; i++)
 		{
-		case BinaryExpr::Type::Addition:
-		case BinaryExpr::Type::Subtraction:
-			return 0;
+			// Note: Lazy scopes refer to a token, which doesn't move.
+			const ScopeStatement& scope = program.m_Scopes[i];
+			m_Scopes[base.Scopes + i] = (scope.IsLazy() ? scope : ScopeStatement{ scope.First + base.ScopeStatements, scope.Count });
+		}
+		for (uint32_t i = 0; i < sizes.ScopeStatements; i++)
+			m_ScopeStatements[base.ScopeStatements + i] = Offset(program.m_ScopeStatements[i], base.Statements);
 
-		case BinaryExpr::Type::Multiplication:
-		case BinaryExpr::Type::Division:
-			return 1;
+		const StatementRange topLevel = program.GetStatements();
+		for (uint32_t i = 0; i < sizes.TopLevel; i++)
+			m_ScopeStatements[m_Statements.First + base.TopLevel + i] = Offset(topLevel[i], base.Statements);
 
-		// TODO: Additional binary operators
+		// Condition branches
+		for (uint32_t i = 0; i < sizes.Branches; i++)
+		{
+			const ConditionBranch::Kind kind = program.m_BranchKinds[i];
+			const uint32_t data = program.m_BranchData[i];
 
-		default:
-			break;
+			m_BranchKinds[base.Branches + i] = kind;
+
+			uint32_t& target = m_BranchData[base.Branches + i];
+			switch (kind)
+			{
+			case ConditionBranch::Kind::ElseIf:	target = data + base.ElseIfs; break;
+			case ConditionBranch::Kind::Else:	target = data + base.Scopes; break;
+
+			default:
+				target = data;
+				break;
+			}
 		}
 
-		//DY_LOG_ERROR("BinaryExpr::Type's precendce level has not been implemented.");
-		return {};
+		for (uint32_t i = 0; i < sizes.ElseIfs; i++)
+		{
+			const ElseIfBranch& elseIf = program.m_ElseIfs[i];
+			m_ElseIfs[base.ElseIfs + i] = { Offset(elseIf.ExprObj, base.Expressions), Offset(elseIf.Scope, base.Scopes), Offset(elseIf.Next, base.Branches) };
+		}
 	}
 
-	// Note: Has to be manually updated
-	std::string FormatExpressionData(const Reference<Expression> expr)
+	size_t Program::GetMemoryUsage() const
 	{
-		return std::visit([](auto&& obj) -> std::string
-		{
-			if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<TermExpr>>)
-			{
-				return std::visit([](auto&& obj) -> std::string
-				{
-					if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<LiteralTerm>>)
-						return FormatToken(obj->TokenObj);
-					else if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<IdentifierTerm>>)
-						return FormatToken(obj->TokenObj);
-					else if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<ParenthesisTerm>>)
-							return Pulse::Text::Format("({0})", FormatExpressionData(obj->ExprObj));
-
-					return "Undefined Term Type";
-				}, obj->TermObj);
-			}
-			else if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<BinaryExpr>>)
-			{
-				return Pulse::Text::Format("LHS: {0}, '{1}' RHS: {2}", 
-					FormatExpressionData(obj->LHS), (char)obj->BinaryType, FormatExpressionData(obj->RHS));
-			}
+		return m_ExprKinds.GetMemoryUsage() + m_ExprTypes.GetMemoryUsage() + m_ExprData.GetMemoryUsage() +
+			m_Literals.GetMemoryUsage() + m_Identifiers.GetMemoryUsage() + m_Binaries.GetMemoryUsage() +
+			m_StatementKinds.GetMemoryUsage() + m_StatementData.GetMemoryUsage() +
+			m_Variables.GetMemoryUsage() + m_Ifs.GetMemoryUsage() + m_Assignments.GetMemoryUsage() +
+			m_Scopes.GetMemoryUsage() + m_ScopeStatements.GetMemoryUsage() +
+			m_BranchKinds.GetMemoryUsage() + m_BranchData.GetMemoryUsage() + m_ElseIfs.GetMemoryUsage();
+	}
 
-			return "Undefined Expression Data";
-		},
-		expr->ExprObj);
+	void Program::Expand(Reference<ScopeStatement> scope)
+	{
+		if (!IsLazy(scope))
+			return;
+
+		const Reference<ScopeStatement> body = m_BodyParser->ParseBody(*this, m_Scopes[scope.Index].First);
+		m_Scopes[scope.Index] = m_Scopes[body.Index];
+	}
+
+	void Program::Expand()
+	{
+		// Note: Only top level scopes are lazy, so the scopes added by parsing a body are never lazy.
+		const uint32_t count = m_Scopes.Size();
+		for (uint32_t i = 0; i < count; i++)
+			Expand(Reference<ScopeStatement>{ i });
 	}
 
-	// Note: Has to be manually updated
-	std::string FormatConditionBranch(const Reference<ConditionBranch> expr)
+	Program::Sizes Program::GetSizes() const
 	{
-		return std::visit([](auto&& obj) -> std::string
+		Sizes sizes = { };
+		sizes.Expressions = m_ExprKinds.Size();
+		sizes.Literals = m_Literals.Size();
+		sizes.Identifiers = m_Identifiers.Size();
+		sizes.Binaries = m_Binaries.Size();
+
+		sizes.Statements = m_StatementKinds.Size();
+		sizes.Variables = m_Variables.Size();
+		sizes.Ifs = m_Ifs.Size();
+		sizes.Assignments = m_Assignments.Size();
+
+		// Note: The top level statements are copied separately, so they are left out if they're at the end.
+		sizes.Scopes = m_Scopes.Size();
+		sizes.ScopeStatements = (m_Statements.First + m_Statements.Count == m_ScopeStatements.Size() ? m_Statements.First : m_ScopeStatements.Size());
+		sizes.TopLevel = m_Statements.Count;
+
+		sizes.Branches = m_BranchKinds.Size();
+		sizes.ElseIfs = m_ElseIfs.Size();
+		return sizes;
+	}
+
+	Program::Sizes Program::GetMergeBase(const Program* programs, size_t index)
+	{
+		Sizes base = { };
+		for (size_t i = 0; i < index; i++)
 		{
-			if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<ElseIfBranch>>)
-			{
-				std::string str = "\nelse if (" + FormatExpressionData(obj->ExprObj) + ")";
+			const Sizes sizes = programs[i].GetSizes();
 
-				// Note: Maybe this should be changed, since we don't clear the memory.
-				str += FormatStatementData(Node::Statement::New(obj->Scope));
+			base.Expressions += sizes.Expressions;
+			base.Literals += sizes.Literals;
+			base.Identifiers += sizes.Identifiers;
+			base.Binaries += sizes.Binaries;
 
-				if (obj->Next.has_value())
-					str += FormatConditionBranch(obj->Next.value());
+			base.Statements += sizes.Statements;
+			base.Variables += sizes.Variables;
+			base.Ifs += sizes.Ifs;
+			base.Assignments += sizes.Assignments;
 
-				return str;
-			}
-			else if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<ElseBranch>>)
-			{
-				std::string str = "\nelse";
+			base.Scopes += sizes.Scopes;
+			base.ScopeStatements += sizes.ScopeStatements;
+			base.TopLevel += sizes.TopLevel;
 
-				// Note: Maybe this should be changed, since we don't clear the memory.
-				str += FormatStatementData(Node::Statement::New(obj->Scope));
+			base.Branches += sizes.Branches;
+			base.ElseIfs += sizes.ElseIfs;
+		}
 
-				return str;
-			}
+		return base;
+	}
 
-			return "Undefined Condition Branch";
-		}, expr->ConditionObj);
+	/////////////////////////////////////////////////////////////////
+	// Allocation
+	/////////////////////////////////////////////////////////////////
+	void SetArena(Arena* arena)
+	{
+		s_Arena = arena;
 	}
 
-	// Note: Has to be manually updated
-	std::string FormatStatementData(const Reference<Statement> statement)
+	Arena& GetArena()
 	{
-		return std::visit([](auto&& obj) -> std::string
+		DY_ASSERT(s_Arena, "No arena has been set for the current thread.");
+		return *s_Arena;
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// Helper functions
+	/////////////////////////////////////////////////////////////////
+	// Note: Has to be manually updated (in Format())
+	std::string FormatExpressionData(const Program& program, Reference<Expression> expr)
+	{
+		std::string str;
+		Format(program, { FormatWork::Kind::Expression, expr.Index }, str);
+		return str;
+	}
+
+	// Note: Has to be manually updated (in Format())
+	std::string FormatConditionBranch(const Program& program, Reference<ConditionBranch> branch)
+	{
+		std::string str;
+		Format(program, { FormatWork::Kind::Branch, branch.Index }, str);
+		return str;
+	}
+
+	// Note: Has to be manually updated (in Format())
+	std::string FormatStatementData(const Program& program, Reference<Statement> statement)
+	{
+		std::string str;
+		Format(program, { FormatWork::Kind::Statement, statement.Index }, str);
+		return str;
+	}
+
+	ConstantValue EvaluateExact(BinaryExpr::Type op, const ConstantValue& lhs, const ConstantValue& rhs)
+	{
+		if (!ValueTypeIsInteger(lhs.Type) || !ValueTypeIsInteger(rhs.Type))
+			return {};
+
+		const Exact left = GetExact(lhs);
+		Exact right = GetExact(rhs);
+		Exact result = {};
+
+		switch (op)
 		{
-			if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<VariableStatement>>)
-			{
-				return Pulse::Text::Format("[Variable({0})] - {1}([{2}])", ValueTypeToStr(obj->Type), FormatToken(obj->TokenObj), FormatExpressionData(obj->ExprObj));
-			}
-			else if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<ExitStatement>>)
+		case BinaryExpr::Type::Subtraction:
+			right.Negative = !right.Negative;
+			[[fallthrough]];
+		case BinaryExpr::Type::Addition:
+		{
+			if (left.Negative == right.Negative)
 			{
-				return Pulse::Text::Format("[Exit] - {0}", FormatExpressionData(obj->ExprObj));
+				result = { left.Negative, left.Magnitude + right.Magnitude };
+				if (result.Magnitude < left.Magnitude)
+					return {};
 			}
-			else if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<ScopeStatement>>)
-			{
-				std::string str = "\n{{\n";
-				for (const auto& statement : obj->Statements)
-					str += "\n\t" + FormatStatementData(statement);
+			else if (left.Magnitude >= right.Magnitude)
+				result = { left.Negative, left.Magnitude - right.Magnitude };
+			else
+				result = { right.Negative, right.Magnitude - left.Magnitude };
+			break;
+		}
+		case BinaryExpr::Type::Multiplication:
+		{
+			if (left.Magnitude != 0 && right.Magnitude > std::numeric_limits<uint64_t>::max() / left.Magnitude)
+				return {};
 
-				str += "\n}}";
-				return str;
-			}
-			else if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<IfStatement>>)
+			result = { left.Negative != right.Negative, left.Magnitude * right.Magnitude };
+			break;
+		}
+		case BinaryExpr::Type::Division:
+		{
+			// Note: Rounds towards 0, like the generated code.
+			if (right.Magnitude == 0)
+				return {};
+
+			result = { left.Negative != right.Negative, left.Magnitude / right.Magnitude };
+			break;
+		}
+
+		case BinaryExpr::Type::Or:
+		case BinaryExpr::Type::And:
+		case BinaryExpr::Type::Xor:
+		{
+			// Note: Works on the two's complement of the values, the bits above
+			// the lowest 64 are all the sign, so they follow from the signs.
+			auto apply = [op](auto lhs, auto rhs)
 			{
-				std::string str = "\nif (" + FormatExpressionData(obj->ExprObj) + ")";
+				if (op == BinaryExpr::Type::Or)
+					return lhs | rhs;
+				if (op == BinaryExpr::Type::And)
+					return lhs & rhs;
+				return lhs ^ rhs;
+			};
+
+			const bool negative = apply(left.Negative, right.Negative);
+			const uint64_t bits = apply(GetConstantBits(lhs), GetConstantBits(rhs));
+			if (negative && static_cast<int64_t>(bits) >= 0)
+				return {};
+
+			result = { negative, (negative ? 0 - bits : bits) };
+			break;
+		}
 
-				// Note: Maybe this should be changed, since we don't clear the memory.
-				str += FormatStatementData(Node::Statement::New(obj->Scope));
+		default:
+			return {};
+		}
 
-				if (obj->Next.has_value())
-					str += FormatConditionBranch(obj->Next.value());
+		// Note: -0 is 0 & the smallest i64 is the most negative value that fits.
+		result.Negative = (result.Negative && result.Magnitude != 0);
+		if (result.Negative && result.Magnitude > (1ull << 63))
+			return {};
 
-				return str;
-			}
-			else if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Reference<AssignmentStatement>>)
-			{
-				return Pulse::Text::Format("[Assignment] - {0}([{1}])", FormatToken(obj->TokenObj), FormatExpressionData(obj->ExprObj));
-			}
+		ConstantValue value = {};
+		if (result.Negative)
+		{
+			value.Type = ValueType::Int64;
+			value.Int = static_cast<int64_t>(0 - result.Magnitude);
+		}
+		else
+		{
+			value.Type = ValueType::UInt64;
+			value.UInt = result.Magnitude;
+		}
 
-			return "Undefined Statement Data";
-		},
-		statement->StatementObj);
+		value.Type = ValueTypeSmallest({ &value, 1 });
+		return value;
 	}
 
 }
\ No newline at end of file
@@ -1,56 +1,65 @@
 #pragma once
 
+#include "Dynamite/Core/Arena.hpp"
+#include "Dynamite/Core/ArenaPool.hpp"
+#include "Dynamite/Core/Interner.hpp"
+#include "Dynamite/Core/SourceLocation.hpp"
+
 #include "Dynamite/Tokens/Token.hpp"
 
 #include "Dynamite/Parsing/Variables.hpp"
 
-#include <Pulse/Memory/ArenaAllocator.hpp>
-
-#include <vector>
-#include <variant>
+#include <array>
+#include <cstdint>
 #include <string>
 #include <optional>
-#include <functional>
+#include <string_view>
 
 namespace Dynamite::Node
 {
 
-    template<typename ...Types>
-    using Variant = std::variant<Types...>;
-
     // Internal reference type.
+    // Note: A 32 bit index into the pools of a Program, T is the kind of node
+    // it refers to so references to different kinds can't be mixed up.
     template<typename T>
-    using Reference = T*;
-
-    constexpr const Reference<void> NullRef = nullptr;
-
-	/////////////////////////////////////////////////////////////////
-	struct Expression;
+    struct Reference
+    {
+    public:
+        constexpr static const uint32_t InvalidIndex = static_cast<uint32_t>(-1);
 
-	// Expression types
-	struct TermExpr;
-	struct BinaryExpr;
+        uint32_t Index = InvalidIndex;
 
-    // Term variants
-	struct IdentifierTerm;
-	struct LiteralTerm;
-    struct ParenthesisTerm;
+    public:
+        inline bool IsValid() const { return Index != InvalidIndex; }
 
-    // Binary is not a variant, since we just store the
-    // operator and the LHS & RHS, and can switch based on that.
+        inline bool operator == (const Reference<T>& other) const { return Index == other.Index; }
+        inline bool operator != (const Reference<T>& other) const { return Index != other.Index; }
+    };
 
-	struct Statement;
+	/////////////////////////////////////////////////////////////////
+    // Note: Expressions, statements & condition branches each have a table of
+    // kinds (stored contiguously) and per kind pools with the node data.
+    // Kinds whose data is a single reference (exit, else) store that
+    // reference in the table directly and have no pool. Parentheses only
+    // group, they're part of the shape of the tree and have no node.
+	/////////////////////////////////////////////////////////////////
+	struct Expression
+    {
+    public:
+        enum class Kind : uint8_t { None = 0, Literal, Identifier, Binary };
+    };
 
-	// Statement types
-    struct ElseIfBranch;
-    struct ElseBranch;
-    struct ScopeStatement;
-    struct ConditionBranch; // Note: This is just for wrapping else if and else statements
-    struct IfStatement;
+	struct Statement
+    {
+    public:
+        enum class Kind : uint8_t { None = 0, Variable, Exit, Scope, If, Assignment };
+    };
 
-	struct VariableStatement;
-	struct ExitStatement;
-    struct AssignmentStatement;
+    struct ConditionBranch // Note: This is just for wrapping else if and else statements
+    {
+    public:
+        enum class Kind : uint8_t { None = 0, ElseIf, Else };
+    };
 	/////////////////////////////////////////////////////////////////
 
 	/////////////////////////////////////////////////////////////////
@@ -66,67 +75,19 @@ namespace Dynamite::Node
             Char = (uint8_t)TokenType::CharLiteral,
             String = (uint8_t)TokenType::StringLiteral,
         };
-    private:
-        LiteralTerm(Type literalType, const Token& token);
-
     public:
-        Type LiteralType;
-        Token TokenObj;
-
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
-
-        [[nodiscard]] static Reference<LiteralTerm> New(Type literalType = Type::None, const Token& token = {});
+        Type LiteralType = Type::None;
+        SourceLocation Location = {};
+        ConstantValue Value = {};
     };
 
     struct IdentifierTerm
     {
-    private:
-        IdentifierTerm(const Token& token);
-
-    public:
-        Token TokenObj;
-
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
-
-        [[nodiscard]] static Reference<IdentifierTerm> New(const Token& token = {});
-    };
-
-    struct ParenthesisTerm // Note: We have this as a seperate term, to support expressions within parenthesis.
-    {
-    private:
-        ParenthesisTerm(Reference<Expression> expr);
-
     public:
-        Reference<Expression> ExprObj;
-
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
-
-        [[nodiscard]] static Reference<ParenthesisTerm> New(Reference<Expression> expr);
+        SymbolId Symbol = InvalidSymbol;
+        SourceLocation Location = {};
     };
 
-    struct TermExpr
-    {
-    private:
-        TermExpr(Variant<Reference<LiteralTerm>, Reference<IdentifierTerm>, Reference<ParenthesisTerm>> term);
-
-    public:
-        Variant<Reference<LiteralTerm>, Reference<IdentifierTerm>, Reference<ParenthesisTerm>> TermObj;
-
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
-
-        [[nodiscard]] static Reference<TermExpr> New(Variant<Reference<LiteralTerm>, Reference<IdentifierTerm>, Reference<ParenthesisTerm>> = {});
-    };
-	/////////////////////////////////////////////////////////////////
-
-    /////////////////////////////////////////////////////////////////
     struct BinaryExpr
     {
     public:
@@ -141,208 +102,340 @@ namespace Dynamite::Node
             Or = (uint8_t)TokenType::Or,
             And = (uint8_t)TokenType::And,
             Xor = (uint8_t)TokenType::Xor,
-        };
-    private:
-        BinaryExpr(Type binaryType, Reference<Expression> lhs, Reference<Expression> rhs);
 
-    public:
-        Type BinaryType;
-        Reference<Expression> LHS;
-        Reference<Expression> RHS;
+            Equal = (uint8_t)TokenType::Equal,
+            NotEqual = (uint8_t)TokenType::NotEqual,
+            Less = (uint8_t)TokenType::Less,
+            Greater = (uint8_t)TokenType::Greater,
+            LessEqual = (uint8_t)TokenType::LessEqual,
+            GreaterEqual = (uint8_t)TokenType::GreaterEqual,
 
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
-
-        [[nodiscard]] static Reference<BinaryExpr> New(Type binaryType = Type::None, Reference<Expression> lhs = (Reference<Expression>)NullRef, Reference<Expression> rhs = (Reference<Expression>)NullRef);
+            LogicalAnd = (uint8_t)TokenType::LogicalAnd,
+            LogicalOr = (uint8_t)TokenType::LogicalOr,
+        };
+    public:
+        Type BinaryType = Type::None;
+        Reference<Expression> LHS = {};
+        Reference<Expression> RHS = {};
     };
-	/////////////////////////////////////////////////////////////////
 
     /////////////////////////////////////////////////////////////////
-    struct Expression
-    {
-    private:
-        Expression(ValueType type, Variant<Reference<TermExpr>, Reference<BinaryExpr>> expr);
+    // Binary operators
+    /////////////////////////////////////////////////////////////////
+    enum class Associativity : uint8_t { Left, Right };
 
+    struct BinaryOperator
+    {
     public:
-        ValueType Type;
-        Variant<Reference<TermExpr>, Reference<BinaryExpr>> ExprObj;
+        uint8_t Power = 0; // Binding power, higher binds tighter. 0 if it's not an operator.
+        Associativity Assoc = Associativity::Left;
+        bool Comparison = false; // Note: Comparisons & logical operators result in a bool.
 
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
-
-        [[nodiscard]] static Reference<Expression> New(ValueType type = ValueType::None, Variant<Reference<TermExpr>, Reference<BinaryExpr>> expr = {});
+        std::string_view Text = {};
     };
-	/////////////////////////////////////////////////////////////////
 
+    // Note: Indexed by BinaryExpr::Type, which is the TokenType of the operator.
+    constexpr const std::array<BinaryOperator, 256> BinaryOperators = []()
+    {
+        std::array<BinaryOperator, 256> operators = { };
+        auto set = [&operators](BinaryExpr::Type type, uint8_t power, bool comparison, std::string_view text)
+        {
+            operators[static_cast<uint8_t>(type)] = { power, Associativity::Left, comparison, text };
+        };
 
+        set(BinaryExpr::Type::LogicalOr, 1, true, "||");
+        set(BinaryExpr::Type::LogicalAnd, 2, true, "&&");
 
-	/////////////////////////////////////////////////////////////////
-    struct ElseIfBranch
-    {
-    private:
-        ElseIfBranch(Reference<Expression> expr, Reference<ScopeStatement> scope, std::optional<Reference<ConditionBranch>> next);
+        set(BinaryExpr::Type::Or, 3, false, "|");
+        set(BinaryExpr::Type::Xor, 4, false, "^");
+        set(BinaryExpr::Type::And, 5, false, "&");
 
-    public:
-        Reference<Expression> ExprObj;
-        Reference<ScopeStatement> Scope;
+        set(BinaryExpr::Type::Equal, 6, true, "==");
+        set(BinaryExpr::Type::NotEqual, 6, true, "!=");
+        set(BinaryExpr::Type::Less, 7, true, "<");
+        set(BinaryExpr::Type::Greater, 7, true, ">");
+        set(BinaryExpr::Type::LessEqual, 7, true, "<=");
+        set(BinaryExpr::Type::GreaterEqual, 7, true, ">=");
 
-        // Note: Optional next branch, can be else if or else.
-        std::optional<Reference<ConditionBranch>> Next;
+        set(BinaryExpr::Type::Addition, 8, false, "+");
+        set(BinaryExpr::Type::Subtraction, 8, false, "-");
+        set(BinaryExpr::Type::Multiplication, 9, false, "*");
+        set(BinaryExpr::Type::Division, 9, false, "/");
 
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
+        return operators;
+    }();
 
-        [[nodiscard]] static Reference<ElseIfBranch> New(Reference<Expression> expr = (Reference<Expression>)NullRef, Reference<ScopeStatement> scope = (Reference<ScopeStatement>)NullRef, std::optional<Reference<ConditionBranch>> next = {});
-    };
-    
-    struct ElseBranch
-    {
-    private:
-        ElseBranch(Reference<ScopeStatement> scope);
+    constexpr const BinaryOperator& GetBinaryOperator(BinaryExpr::Type type) { return BinaryOperators[static_cast<uint8_t>(type)]; }
+	/////////////////////////////////////////////////////////////////
 
+	/////////////////////////////////////////////////////////////////
+    // Note: The statements of a scope are stored contiguously. A lazy scope
+    // hasn't been parsed yet, First is the index of its `{` token then.
+    struct ScopeStatement
+    {
     public:
-        Reference<ScopeStatement> Scope;
+        constexpr static const uint32_t LazyCount = static_cast<uint32_t>(-1);
 
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
+        uint32_t First = 0;
+        uint32_t Count = 0;
 
-        [[nodiscard]] static Reference<ElseBranch> New(Reference<ScopeStatement> scope = (Reference<ScopeStatement>)NullRef);
+    public:
+        inline bool IsLazy() const { return Count == LazyCount; }
     };
 
-    struct ConditionBranch
+    struct ElseIfBranch
     {
-    private:
-        ConditionBranch(Variant<Reference<ElseIfBranch>, Reference<ElseBranch>> branch);
-
     public:
-        Variant<Reference<ElseIfBranch>, Reference<ElseBranch>> ConditionObj;
-
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
+        Reference<Expression> ExprObj = {};
+        Reference<ScopeStatement> Scope = {};
 
-        [[nodiscard]] static Reference<ConditionBranch> New(Variant<Reference<ElseIfBranch>, Reference<ElseBranch>> branch = {});
+        // Note: Optional next branch, can be else if or else.
+        Reference<ConditionBranch> Next = {};
     };
 
     struct IfStatement
     {
-    private:
-        IfStatement(Reference<Expression> expr, Reference<ScopeStatement> scope, std::optional<Reference<ConditionBranch>> next);
-
     public:
-        Reference<Expression> ExprObj;
-        Reference<ScopeStatement> Scope;
+        Reference<Expression> ExprObj = {};
+        Reference<ScopeStatement> Scope = {};
 
         // Note: Optional next branch, can be else if or else.
-        std::optional<Reference<ConditionBranch>> Next;
+        Reference<ConditionBranch> Next = {};
+    };
 
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
+    struct VariableStatement
+    {
+    public:
+        ValueType Type = ValueType::None;
+        SymbolId Symbol = InvalidSymbol;
+        SourceLocation Location = {};
+        Reference<Expression> ExprObj = {};
+    };
 
-        [[nodiscard]] static Reference<IfStatement> New(Reference<Expression> expr = (Reference<Expression>)NullRef, Reference<ScopeStatement> scope = (Reference<ScopeStatement>)NullRef, std::optional<Reference<ConditionBranch>> next = {});
+    struct AssignmentStatement
+    {
+    public:
+        SymbolId Symbol = InvalidSymbol;
+        SourceLocation Location = {};
+        Reference<Expression> ExprObj = {};
     };
 	/////////////////////////////////////////////////////////////////
 
 	/////////////////////////////////////////////////////////////////
-    struct VariableStatement
+    // Note: An iterable view over contiguous statements.
+    class StatementRange
     {
-    private:
-        VariableStatement(ValueType type, const Token& token, Reference<Expression> expr);
+    public:
+        class Iterator
+        {
+        public:
+            Iterator(const ArenaPool<Reference<Statement>>* pool, uint32_t index)
+                : m_Pool(pool), m_Index(index) {}
+
+            inline Reference<Statement> operator * () const { return (*m_Pool)[m_Index]; }
+            inline Iterator& operator ++ () { m_Index++; return *this; }
+            inline bool operator != (const Iterator& other) const { return m_Index != other.m_Index; }
+
+        private:
+            const ArenaPool<Reference<Statement>>* m_Pool;
+            uint32_t m_Index;
+        };
 
     public:
-        ValueType Type;
-        Token TokenObj;
-        Reference<Expression> ExprObj;
+        StatementRange(const ArenaPool<Reference<Statement>>* pool, ScopeStatement scope)
+            : m_Pool(pool), m_Scope(scope) {}
 
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
+        inline Iterator begin() const { return { m_Pool, m_Scope.First }; }
+        inline Iterator end() const { return { m_Pool, m_Scope.First + m_Scope.Count }; }
 
-        [[nodiscard]] static Reference<VariableStatement> New(ValueType type = ValueType::None, const Token& token = {}, Reference<Expression> expr = (Reference<Expression>)NullRef);
-    };
+        inline Reference<Statement> operator [] (size_t index) const { return (*m_Pool)[m_Scope.First + static_cast<uint32_t>(index)]; }
+
+        inline size_t Size() const { return m_Scope.Count; }
+        inline bool Empty() const { return m_Scope.Count == 0; }
 
-    struct ExitStatement
-    {
     private:
-        ExitStatement(Reference<Expression> expr);
+        const ArenaPool<Reference<Statement>>* m_Pool;
+        ScopeStatement m_Scope;
+    };
+	/////////////////////////////////////////////////////////////////
 
-    public:
-        Reference<Expression> ExprObj;
+	/////////////////////////////////////////////////////////////////
+    class Program;
 
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
+    // Note: Parses the bodies of lazy scopes, when they're expanded.
+    class BodyParser
+    {
+    public:
+        virtual ~BodyParser() = default;
 
-        [[nodiscard]] static Reference<ExitStatement> New(Reference<Expression> expr = (Reference<Expression>)NullRef);
+        // Parses the scope that opens at the `{` token at index, the nodes are added to program.
+        virtual Reference<ScopeStatement> ParseBody(Program& program, uint32_t index) = 0;
     };
 
-    struct ScopeStatement
+    // Note: Owns every node of a compilation unit, all pools live in the arena
+    // passed in, so the Program is only valid until that arena gets reset.
+    // Copies are shallow.
+    class Program
     {
-    private:
-        ScopeStatement(const std::vector<Reference<Statement>>& statements);
-
     public:
-        std::vector<Reference<Statement>> Statements;
+        Program() = default;
+        Program(Arena& arena, const Interner& symbols);
+        ~Program() = default;
+
+        // Expressions
+        Reference<Expression> AddLiteral(ValueType type, const LiteralTerm& literal);
+        Reference<Expression> AddIdentifier(ValueType type, const IdentifierTerm& identifier);
+        Reference<Expression> AddBinary(ValueType type, const BinaryExpr& binary);
+
+        inline Expression::Kind GetKind(Reference<Expression> expr) const { return m_ExprKinds[expr.Index]; }
+        inline ValueType GetType(Reference<Expression> expr) const { return m_ExprTypes[expr.Index]; }
+        inline void SetType(Reference<Expression> expr, ValueType type) { m_ExprTypes[expr.Index] = type; }
+
+        inline LiteralTerm& GetLiteral(Reference<Expression> expr) { return m_Literals[m_ExprData[expr.Index]]; }
+        inline const LiteralTerm& GetLiteral(Reference<Expression> expr) const { return m_Literals[m_ExprData[expr.Index]]; }
+        inline const IdentifierTerm& GetIdentifier(Reference<Expression> expr) const { return m_Identifiers[m_ExprData[expr.Index]]; }
+        inline const BinaryExpr& GetBinary(Reference<Expression> expr) const { return m_Binaries[m_ExprData[expr.Index]]; }
+
+        // Statements
+        Reference<Statement> AddVariable(const VariableStatement& variable);
+        Reference<Statement> AddExit(Reference<Expression> expr);
+        Reference<Statement> AddScope(Reference<ScopeStatement> scope);
+        Reference<Statement> AddIf(const IfStatement& ifStatement);
+        Reference<Statement> AddAssignment(const AssignmentStatement& assignment);
+
+        // Note: Copies the statements, so they are stored contiguously.
+        Reference<ScopeStatement> AddScopeBody(const Reference<Statement>* statements, size_t count);
+
+        inline Statement::Kind GetKind(Reference<Statement> statement) const { return m_StatementKinds[statement.Index]; }
+
+        inline const VariableStatement& GetVariable(Reference<Statement> statement) const { return m_Variables[m_StatementData[statement.Index]]; }
+        inline Reference<Expression> GetExit(Reference<Statement> statement) const { return { m_StatementData[statement.Index] }; }
+        inline Reference<ScopeStatement> GetScope(Reference<Statement> statement) const { return { m_StatementData[statement.Index] }; }
+        inline const IfStatement& GetIf(Reference<Statement> statement) const { return m_Ifs[m_StatementData[statement.Index]]; }
+        inline const AssignmentStatement& GetAssignment(Reference<Statement> statement) const { return m_Assignments[m_StatementData[statement.Index]]; }
+
+        // Note: The body is parsed by the BodyParser, when the scope is expanded.
+        Reference<ScopeStatement> AddLazyScope(uint32_t index);
+        inline bool IsLazy(Reference<ScopeStatement> scope) const { return m_Scopes[scope.Index].IsLazy(); }
+
+        // Note: Replaces a lazy scope with its parsed body, scopes that aren't lazy are left as is.
+        // Parsing only adds nodes, so references & ranges handed out stay valid.
+        void Expand(Reference<ScopeStatement> scope);
+        // Note: Expands every lazy scope, in source order.
+        void Expand();
+
+        // Note: A lazy scope has no statements until it's expanded.
+        inline StatementRange GetStatements(Reference<ScopeStatement> scope) const { return { &m_ScopeStatements, (IsLazy(scope) ? ScopeStatement() : m_Scopes[scope.Index]) }; }
+
+        // Condition branches
+        Reference<ConditionBranch> AddElseIf(const ElseIfBranch& branch);
+        Reference<ConditionBranch> AddElse(Reference<ScopeStatement> scope);
+
+        inline ConditionBranch::Kind GetKind(Reference<ConditionBranch> branch) const { return m_BranchKinds[branch.Index]; }
+
+        inline const ElseIfBranch& GetElseIf(Reference<ConditionBranch> branch) const { return m_ElseIfs[m_BranchData[branch.Index]]; }
+        inline Reference<ScopeStatement> GetElse(Reference<ConditionBranch> branch) const { return { m_BranchData[branch.Index] }; }
+
+        // Replacing
+        // Note: The node of replacement is shared by both references afterwards, so
+        // everything that refers to the replaced node sees the replacement.
+        void Replace(Reference<Expression> expr, Reference<Expression> replacement);
+        void Replace(Reference<Statement> statement, Reference<Statement> replacement);
+        void Replace(Reference<ConditionBranch> branch, Reference<ConditionBranch> replacement);
+
+        // Note: Keeps the first count statements of the scope.
+        void Truncate(Reference<ScopeStatement> scope, size_t count);
+
+        // Top level statements
+        void SetStatements(const Reference<Statement>* statements, size_t count);
+        void TruncateStatements(size_t count);
+        inline StatementRange GetStatements() const { return { &m_ScopeStatements, m_Statements }; }
+
+        // Note: Merging appends the nodes of all programs in order, the top level statements of
+        // all programs become the top level statements of this (empty) program. PrepareMerge
+        // makes room for all nodes, after which every program is copied with Merge.
+        // Different programs can be merged from different threads.
+        void PrepareMerge(const Program* programs, size_t count);
+        void Merge(const Program* programs, size_t index);
+
+        // Note: Has to be set if the program has lazy scopes, it must outlive the Program.
+        inline void SetBodyParser(BodyParser* parser) { m_BodyParser = parser; }
+
+        // Getters
+        inline const Interner& GetSymbols() const { return *m_Symbols; }
+        inline size_t ExpressionCount() const { return m_ExprKinds.Size(); }
+        inline size_t StatementCount() const { return m_StatementKinds.Size(); }
+
+        // Returns the amount of arena memory used by all pools.
+        size_t GetMemoryUsage() const;
 
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
+    private:
+        // Note: The pool sizes of a program, or the base indices of a program when merging.
+        struct Sizes
+        {
+        public:
+            uint32_t Expressions = 0, Literals = 0, Identifiers = 0, Binaries = 0;
+            uint32_t Statements = 0, Variables = 0, Ifs = 0, Assignments = 0;
+            uint32_t Scopes = 0, ScopeStatements = 0; // Without trailing top level statements
+            uint32_t Branches = 0, ElseIfs = 0;
+            uint32_t TopLevel = 0;
+        };
 
-        [[nodiscard]] static Reference<ScopeStatement> New(const std::vector<Reference<Statement>>& statements = {});
-    };
+        Sizes GetSizes() const;
+        static Sizes GetMergeBase(const Program* programs, size_t index);
 
-    struct AssignmentStatement
-    {
     private:
-        AssignmentStatement(const Token& token, Reference<Expression> expr);
+        const Interner* m_Symbols = nullptr;
+        BodyParser* m_BodyParser = nullptr;
 
-    public:
-        Token TokenObj;
-        Reference<Expression> ExprObj;
+        // Expressions
+        ArenaPool<Expression::Kind> m_ExprKinds = { };
+        ArenaPool<ValueType> m_ExprTypes = { };
+        ArenaPool<uint32_t> m_ExprData = { }; // Index into the pool of the kind
 
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
+        ArenaPool<LiteralTerm> m_Literals = { };
+        ArenaPool<IdentifierTerm> m_Identifiers = { };
+        ArenaPool<BinaryExpr> m_Binaries = { };
 
-        [[nodiscard]] static Reference<AssignmentStatement> New(const Token& token = {}, Reference<Expression> expr = (Reference<Expression>)NullRef);
-    };
+        // Statements
+        ArenaPool<Statement::Kind> m_StatementKinds = { };
+        ArenaPool<uint32_t> m_StatementData = { };
 
-    struct Statement
-    {
-    private:
-        Statement(Variant<Reference<VariableStatement>, Reference<ExitStatement>, Reference<ScopeStatement>, Reference<IfStatement>, Reference<AssignmentStatement>> statement);
+        ArenaPool<VariableStatement> m_Variables = { };
+        ArenaPool<IfStatement> m_Ifs = { };
+        ArenaPool<AssignmentStatement> m_Assignments = { };
 
-    public:
-        Variant<Reference<VariableStatement>, Reference<ExitStatement>, Reference<ScopeStatement>, Reference<IfStatement>, Reference<AssignmentStatement>> StatementObj;
+        ArenaPool<ScopeStatement> m_Scopes = { };
+        ArenaPool<Reference<Statement>> m_ScopeStatements = { };
 
-    public: // Custom allocator functions.
-        template<typename T, typename ...TArgs>
-        friend T* Pulse::Memory::DynamicArenaAllocator::Construct(TArgs&& ...args);
+        // Condition branches
+        ArenaPool<ConditionBranch::Kind> m_BranchKinds = { };
+        ArenaPool<uint32_t> m_BranchData = { };
 
-        [[nodiscard]] static Reference<Statement> New(Variant<Reference<VariableStatement>, Reference<ExitStatement>, Reference<ScopeStatement>, Reference<IfStatement>, Reference<AssignmentStatement>> statement = {});
-    };
-	/////////////////////////////////////////////////////////////////
+        ArenaPool<ElseIfBranch> m_ElseIfs = { };
 
-	/////////////////////////////////////////////////////////////////
-    struct Program
-    {
-    public:
-        std::vector<Reference<Statement>> Statements = { };
+        ScopeStatement m_Statements = { };
     };
 	/////////////////////////////////////////////////////////////////
 
     /////////////////////////////////////////////////////////////////
-    // Helper functions
+    // Allocation
     /////////////////////////////////////////////////////////////////
-    std::optional<size_t> GetBinaryExprPrecendce(BinaryExpr::Type type);
+    // Note: Programs are built in the arena set for the current thread,
+    // it is owned by the compilation unit and must outlive its Program.
+    void SetArena(Arena* arena);
+    Arena& GetArena();
 
-    std::string FormatExpressionData(const Reference<Expression> expr);
-    std::string FormatConditionBranch(const Reference<ConditionBranch> expr);
-    std::string FormatStatementData(const Reference<Statement> statement);
+    /////////////////////////////////////////////////////////////////
+    // Helper functions
+    /////////////////////////////////////////////////////////////////
+    std::string FormatExpressionData(const Program& program, Reference<Expression> expr);
+    std::string FormatConditionBranch(const Program& program, Reference<ConditionBranch> branch);
+    std::string FormatStatementData(const Program& program, Reference<Statement> statement);
+
+    // Returns the exact value of an arithmetic or bitwise operator on integer constants, as the smallest type it fits
+    // in (like an integer literal). Note: Returns ValueType::None for other operators or operands, when dividing by 0
+    // or if the value doesn't fit in 64 bits.
+    ConstantValue EvaluateExact(BinaryExpr::Type op, const ConstantValue& lhs, const ConstantValue& rhs);
 
 }
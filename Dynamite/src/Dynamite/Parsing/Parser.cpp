@@ -7,207 +7,492 @@
 
 #include "Dynamite/Compiler/CompilerSuite.hpp"
 
-#include <Pulse/Types/TypeUtils.hpp>
-
 namespace Dynamite
 {
 
-	#define PeekCheck(offset, type) (Peek(offset).has_value() && Peek(offset).value().Type == type)
+	namespace
+	{
+		// Note: Have to be manually updated
+		constexpr static const TokenTypeSet s_LiteralTokens = {
+			TokenType::BoolLiteral,
+			TokenType::IntegerLiteral,
+			TokenType::FloatLiteral,
+			TokenType::CharLiteral,
+			TokenType::StringLiteral
+		};
+
+		constexpr static const TokenTypeSet s_ValueTypeTokens = {
+			TokenType::Bool,
+
+			TokenType::Int8,
+			TokenType::Int16,
+			TokenType::Int32,
+			TokenType::Int64,
+
+			TokenType::UInt8,
+			TokenType::UInt16,
+			TokenType::UInt32,
+			TokenType::UInt64,
+
+			TokenType::Float32,
+			TokenType::Float64,
+
+			TokenType::Char,
+			TokenType::String
+		};
+
+		// Note: A literal operand takes the type of the other operand if its value fits in it, so `x / 2`
+		// & `x < 3` are done in the type of x (non negative literals are unsigned by default).
+		static void AdaptLiteral(Node::Program& program, Node::Reference<Node::Expression> expr, ValueType type)
+		{
+			if (program.GetKind(expr) != Node::Expression::Kind::Literal)
+				return;
+
+			Node::LiteralTerm& literal = program.GetLiteral(expr);
+			const bool integer = (ValueTypeIsInteger(literal.Value.Type) && ValueTypeIsInteger(type));
+			const bool floating = (ValueTypeIsFloat(literal.Value.Type) && ValueTypeIsFloat(type));
+			if ((!integer && !floating) || !ValueTypeFits(type, literal.Value))
+				return;
+
+			literal.Value = ValueTypeConvert(type, literal.Value).value();
+			program.SetType(expr, type);
+		}
+
+		/////////////////////////////////////////////////////////////////
+		// Parallel parsing
+		/////////////////////////////////////////////////////////////////
+		// Note: Below this amount of tokens splitting costs more than it saves.
+		constexpr static const size_t s_MinParallelTokens = 64ull * 1024;
+		constexpr static const size_t s_MinRangeTokens = 16ull * 1024;
+
+		struct Range
+		{
+		public:
+			size_t Begin = 0;
+			size_t End = 0;
+
+			Node::Program Program = {};
+			std::vector<Diagnostic> Diagnostics = { };
+			bool Independent = false; // Parsed exactly as it would have been in sequence
+		};
+	}
 
 	/////////////////////////////////////////////////////////////////
 	// Main functions
 	/////////////////////////////////////////////////////////////////
-	Parser::Parser(std::vector<Token>& tokens)
-		: m_Tokens(tokens)
+	Parser::Parser(TokenStream& tokens, ThreadPool& threadPool, size_t maxNesting, bool lazy)
+		: m_Tokens(tokens), m_ThreadPool(threadPool), m_MaxNesting(maxNesting), m_Lazy(lazy)
 	{
 	}
 
 	Node::Program Parser::GetProgram()
 	{
-		Node::Program program = {};
+		std::optional<Node::Program> program = {};
+		if (!m_Stream && m_ThreadPool.Size() > 1 && m_Tokens.Size() >= s_MinParallelTokens)
+			program = GetProgramParallel();
+
+		if (!program.has_value())
+		{
+			// Note: The top level variables are collected while parsing.
+			m_TopLevelTokens.clear();
+			program = GetProgram(0, std::numeric_limits<size_t>::max());
+
+			if (m_Lazy && !m_Stream)
+				SetTopLevel();
+		}
+
+		if (m_Lazy && !m_Stream)
+			program->SetBodyParser(this);
+
+		return program.value();
+	}
+
+	Node::Program Parser::GetProgram(size_t begin, size_t end)
+	{
+		Node::Program program(Node::GetArena(), m_Tokens.GetSymbols());
+		m_Program = &program;
+		m_Index = begin;
 
 		// Parse statements
-		while (Peek().has_value())
+		while (m_Index < end && PeekType() != TokenType::None)
 		{
 			if (auto statement = ParseStatement())
-				program.Statements.emplace_back(statement.value());
+				m_StatementStack.push_back(statement.value());
 			else // Failed to retrieve a valid statement
-				CompilerSuite::Error(GetLineNumber(), "Failed to retrieve a valid statement");
+				CompilerSuite::Error(GetLocation(), "Failed to retrieve a valid statement");
 		}
 
-		m_Index = 0;
+		program.SetStatements(m_StatementStack.data(), m_StatementStack.size());
+		m_StatementStack.clear();
+
+		// Note: SymbolId's are per compilation unit.
+		m_Variables.Clear();
+
+		m_Program = nullptr;
 		return program;
 	}
 
+	Node::Program Parser::GetProgram(Tokenizer& stream)
+	{
+		m_Stream = &stream;
+		m_WindowEnd = 0;
+
+		Node::Program program = GetProgram();
+
+		m_Stream = nullptr;
+		return program;
+	}
+
+	std::optional<Node::Program> Parser::GetProgramParallel()
+	{
+		/////////////////////////////////////////////////////////////////
+		// Pre-scan
+		/////////////////////////////////////////////////////////////////
+		// Note: A range ends after a `;` or `}` at the top level (that isn't
+		// followed by an else). Top level variables are collected, since
+		// they are visible to the ranges after them.
+		const size_t tokenCount = m_Tokens.Size();
+		const size_t rangeSize = std::max(s_MinRangeTokens, tokenCount / (m_ThreadPool.Size() * 4));
+
+		std::vector<size_t> boundaries = { 0 };
+		m_TopLevelTokens.clear();
+
+		size_t depth = 0;
+		for (size_t i = 0; i < tokenCount; i++)
+		{
+			const TokenType type = m_Tokens.GetType(i);
+			switch (type)
+			{
+			case TokenType::OpenCurlyBrace:
+				depth++;
+				break;
+			case TokenType::CloseCurlyBrace:
+				depth -= (depth != 0);
+				[[fallthrough]];
+			case TokenType::Semicolon:
+				if (depth == 0 && i + 1 - boundaries.back() >= rangeSize && i + 1 < tokenCount && m_Tokens.GetType(i + 1) != TokenType::Else)
+					boundaries.push_back(i + 1);
+				break;
+
+			default:
+				if (depth == 0 && i + 2 < tokenCount && s_ValueTypeTokens.Contains(type) && m_Tokens.GetType(i + 1) == TokenType::Identifier && m_Tokens.GetType(i + 2) == TokenType::Equals)
+					m_TopLevelTokens.push_back(i);
+				break;
+			}
+		}
+		boundaries.push_back(tokenCount);
+
+		if (boundaries.size() <= 2)
+			return {};
+
+		SetTopLevel();
+
+		/////////////////////////////////////////////////////////////////
+		// Parsing
+		/////////////////////////////////////////////////////////////////
+		std::vector<Range> ranges(boundaries.size() - 1);
+		while (m_RangeArenas.size() < ranges.size())
+			m_RangeArenas.push_back(Pulse::Unique<Arena>::Create());
+
+		Arena& arena = Node::GetArena();
+		m_ThreadPool.ParallelFor(ranges.size(), [&](size_t i)
+		{
+			Range& range = ranges[i];
+			range.Begin = boundaries[i];
+			range.End = boundaries[i + 1];
+
+			m_RangeArenas[i]->Reset();
+			Node::SetArena(m_RangeArenas[i].Raw());
+			CompilerSuite::DeferDiagnostics(&range.Diagnostics);
+
+			Parser parser(m_Tokens, m_ThreadPool, m_MaxNesting);
+			parser.m_Lazy = m_Lazy;
+			parser.m_Declarations = &m_TopLevel;
+			parser.m_RangeBegin = range.Begin;
+
+			range.Program = parser.GetProgram(range.Begin, range.End);
+
+			// Note: The pre-scan can only be trusted if the range was valid code, with errors
+			// (an unclosed scope for example) statements can end at different tokens.
+			range.Independent = (parser.m_Index == range.End);
+			for (const Diagnostic& diagnostic : range.Diagnostics)
+				range.Independent &= (diagnostic.Level != LogLevel::Error);
+
+			CompilerSuite::DeferDiagnostics(nullptr);
+			Node::SetArena(nullptr);
+		});
+
+		// Note: The calling thread also parsed ranges.
+		Node::SetArena(&arena);
+
+		for (const Range& range : ranges)
+		{
+			if (!range.Independent)
+				return {};
+		}
+
+		/////////////////////////////////////////////////////////////////
+		// Merging
+		/////////////////////////////////////////////////////////////////
+		std::vector<Node::Program> programs;
+		programs.reserve(ranges.size());
+		for (const Range& range : ranges)
+		{
+			CompilerSuite::Report(range.Diagnostics);
+			programs.push_back(range.Program);
+		}
+
+		Node::Program program(arena, m_Tokens.GetSymbols());
+		program.PrepareMerge(programs.data(), programs.size());
+		m_ThreadPool.ParallelFor(programs.size(), [&](size_t i) { program.Merge(programs.data(), i); });
+
+		m_Index = tokenCount;
+		return program;
+	}
+
+	void Parser::SetTopLevel()
+	{
+		// Note: Grouped by symbol with a counting sort, which keeps the source order.
+		m_TopLevel.Offsets.assign(m_Tokens.GetSymbols().Size() + 1, 0);
+		m_TopLevel.Items.resize(m_TopLevelTokens.size());
+
+		for (const size_t index : m_TopLevelTokens)
+			m_TopLevel.Offsets[m_Tokens.GetSymbol(index + 1) + 1]++;
+		for (size_t i = 1; i < m_TopLevel.Offsets.size(); i++)
+			m_TopLevel.Offsets[i] += m_TopLevel.Offsets[i - 1];
+
+		std::vector<uint32_t> next(m_TopLevel.Offsets.begin(), m_TopLevel.Offsets.end() - 1);
+		for (const size_t index : m_TopLevelTokens)
+			m_TopLevel.Items[next[m_Tokens.GetSymbol(index + 1)]++] = { index, static_cast<ValueType>(m_Tokens.GetType(index)) };
+	}
+
+	Node::Reference<Node::ScopeStatement> Parser::ParseBody(Node::Program& program, uint32_t index)
+	{
+		// Note: Bodies are parsed by a separate parser that isn't lazy, so the
+		// nested scopes are parsed right away and our own state is untouched.
+		Parser parser(m_Tokens, m_ThreadPool, m_MaxNesting);
+		parser.m_Program = &program;
+		parser.m_Declarations = &m_TopLevel;
+		parser.m_RangeBegin = index;
+		parser.m_Index = index;
+
+		Node::Reference<Node::Statement> statement = {};
+		if (parser.OpenScope(ScopeKind::Body))
+			parser.ParseScopes(0, StatementResult::Opened, statement);
+
+		return parser.m_Body;
+	}
+
 	/////////////////////////////////////////////////////////////////
 	// Parsing functions
 	/////////////////////////////////////////////////////////////////
-	std::optional<Node::Reference<Node::TermExpr>> Parser::ParseTermExpr()
+	std::optional<Node::Reference<Node::Expression>> Parser::ParseTermExpr()
 	{
 		if (auto literalTerm = TryConsumeLiteral())
 		{
-			return Node::TermExpr::New(Node::LiteralTerm::New(static_cast<Node::LiteralTerm::Type>(literalTerm.value().Type), literalTerm.value()));
+			// Note: The value has already been decoded by the tokenizer.
+			const ConstantValue& value = GetConstant(m_Index - 1);
+			return m_Program->AddLiteral(value.Type, { static_cast<Node::LiteralTerm::Type>(literalTerm.value().Type), literalTerm.value().Location, value });
 		}
 		else if (auto identifier = TryConsume(TokenType::Identifier))
 		{
-			return Node::TermExpr::New(Node::IdentifierTerm::New(identifier.value()));
-		}
-		else if (auto parenthesis = TryConsume(TokenType::OpenParenthesis))
-		{
-			auto expr = ParseExpr();
-			if (!expr.has_value())
-			{
-				CompilerSuite::Error(GetLineNumber(), "Failed to retrieve a valid expression");
-				return {};
-			}
-
-			CheckConsume(TokenType::CloseParenthesis, "Expected `)`");
-
-			return Node::TermExpr::New(Node::ParenthesisTerm::New(expr.value()));
+			return m_Program->AddIdentifier(GetVar(identifier.value().Symbol).Type, { identifier.value().Symbol, identifier.value().Location });
 		}
 			
 		return {};
 	}
 
-	std::optional<Node::Reference<Node::Expression>> Parser::ParseExpr(const size_t minimumPrecedence)
+	std::optional<Node::Reference<Node::Expression>> Parser::ParseExpr(const uint8_t minimumPower)
 	{
-		if (auto termLHS = ParseTermExpr())
+		// Note: A Pratt parser, an operator continues the expression of a frame if its binding power
+		// (from Node::BinaryOperators) is at least the minimum of the frame. Every parenthesis & right
+		// hand side gets a frame on m_Expressions, a frame waits for the value below it. The frames
+		// below base belong to whoever called us.
+		const size_t base = m_Expressions.size();
+		size_t depth = 0; // Open parentheses
+
+		m_Expressions.push_back({ .MinimumPower = minimumPower });
+
+		while (true)
 		{
 			/////////////////////////////////////////////////////////////////
-			// Type retrieval
+			// Term resolution
 			/////////////////////////////////////////////////////////////////
-			ValueType type = std::visit([this](auto&& obj) -> ValueType
+			while (PeekCheck(0, TokenType::OpenParenthesis))
 			{
-				if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Node::Reference<Node::LiteralTerm>>)
-					return GetValueType(obj->TokenObj.Type, obj->TokenObj.Value.value());
-				else if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Node::Reference<Node::IdentifierTerm>>)
-					return GetVar(obj->TokenObj.Value.value()).Type;
-				else if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Node::Reference<Node::ParenthesisTerm>>)
-					return obj->ExprObj->Type;
-
-				DY_LOG_ERROR("Retrieving ValueType has not been implemented for current type.");
-				return {};
-			}, termLHS.value()->TermObj);
+				if (depth >= m_MaxNesting)
+				{
+					CompilerSuite::Error(GetLocation(), "Expression nesting exceeds the maximum depth of {0}.", m_MaxNesting);
 
-			/////////////////////////////////////////////////////////////////
-			// Expression retrieval/creation
-			/////////////////////////////////////////////////////////////////
-			Node::Reference<Node::Expression> exprLHS = Node::Expression::New(type, termLHS.value());
-			
-			while (true)
-			{
-				std::optional<Token> current = Peek(0);
-				std::optional<size_t> precedence = {};
-				size_t nextMinimumPrecedence = -1;
-				
-				// Note: It breaks out and just returns the normal expression if
-				// it's not a binary expression.
-				if (!current.has_value())
-					break;
+					// Note: Skips the rest of the expression, so we don't report every
+					// parenthesis that isn't closed. Stops at anything that can't be
+					// part of an expression.
+					while (depth != 0)
+					{
+						const TokenType current = PeekType(0);
+						if (current == TokenType::None || current == TokenType::Semicolon || current == TokenType::OpenCurlyBrace || current == TokenType::CloseCurlyBrace)
+							break;
 
-				precedence = Node::GetBinaryExprPrecendce(static_cast<Node::BinaryExpr::Type>(current->Type));
-				if (!precedence.has_value() || precedence.value() < minimumPrecedence)
-					break;
-				else
-					nextMinimumPrecedence = precedence.value() + 1;
+						if (current == TokenType::OpenParenthesis)
+							depth++;
+						else if (current == TokenType::CloseParenthesis)
+							depth--;
 
-				Token operation = Consume();
+						Consume();
+					}
 
-				auto exprRHS = ParseExpr(nextMinimumPrecedence);
-				if (!exprRHS.has_value()) 
-				{
-					CompilerSuite::Error(GetLineNumber(), "Unable to parse expression.");
-					break;
+					m_Expressions.resize(base);
+					return {};
 				}
 
-				auto expr = Node::BinaryExpr::New(static_cast<Node::BinaryExpr::Type>(operation.Type));
-				auto exprLHS2 = Node::Expression::New(type, exprLHS->ExprObj);
-				
-				expr->LHS = exprLHS2;
-				expr->RHS = exprRHS.value();
+				Consume(); // '(' token
+				depth++;
 
-				exprLHS->ExprObj = expr;
+				m_Expressions.push_back({ .FrameState = ExpressionFrame::State::Parenthesis });
+				m_Expressions.push_back({ .MinimumPower = 0 });
 			}
 
-			// Note: This is either a binary expression or just a normal expression.
-			// The loop up top accounts for both
-			return exprLHS;
-		}
-
-		return {};
-	}
-
-	std::optional<Node::Reference<Node::ScopeStatement>> Parser::ParseScope()
-	{
-		if (!TryConsume(TokenType::OpenCurlyBrace).has_value())
-			return {};
-
-		m_Scopes.push_back(m_Variables.size());
-
-		Node::Reference<Node::ScopeStatement> scope = Node::ScopeStatement::New();
-		while (auto stmt = ParseStatement()) 
-			scope->Statements.push_back(stmt.value());
-
-		// Note: We decrement, since if we did not retrieve any (valid) statements
-		// it will result in consuming the next token just to carry on, but this also means
-		// that the '}' has already been consumed. So we just go one back.
-		m_Index--;
-
-		size_t popCount = m_Variables.size() - m_Scopes.back();
-		PopVar(popCount);
-		m_Scopes.pop_back();
-		
-		CheckConsume(TokenType::CloseCurlyBrace, "Expected `}}`");
-		return scope;
-	}
+			std::optional<Node::Reference<Node::Expression>> value = ParseTermExpr();
 
-	std::optional<Node::Reference<Node::ConditionBranch>> Parser::ParseConditionBrach()
-	{
-		if (PeekCheck(0, TokenType::Else) && PeekCheck(1, TokenType::If)) 
-		{
-			Consume(); // 'else' token
-			Consume(); // 'if' token
-
-			CheckConsume(TokenType::OpenParenthesis, "Expected `(`.");
+			// Note: The exact value of an integer constant (a literal or an operator on constants), ValueType::None otherwise.
+			ConstantValue constant = {};
+			if (value.has_value() && m_Program->GetKind(value.value()) == Node::Expression::Kind::Literal && ValueTypeIsInteger(m_Program->GetType(value.value())))
+				constant = m_Program->GetLiteral(value.value()).Value;
 
-			if (auto expr = ParseExpr())
+			/////////////////////////////////////////////////////////////////
+			// Expression retrieval/creation
+			/////////////////////////////////////////////////////////////////
+			// Note: Hands the value to the frames waiting for it, until
+			// a frame needs a new term (after a binary operator).
+			bool needsTerm = false;
+			while (!needsTerm)
 			{
-				auto elif = Node::ElseIfBranch::New(expr.value());
-
-				CheckConsume(TokenType::CloseParenthesis, "Expected `)`.");
-
-				if (auto scope = ParseScope())
+				ExpressionFrame& frame = m_Expressions.back();
+				if (frame.FrameState == ExpressionFrame::State::Parenthesis)
+				{
+					m_Expressions.pop_back();
+					depth--;
+
+					// Note: The parentheses only group, so the value is passed on as is.
+					if (value.has_value())
+						CheckConsume(TokenType::CloseParenthesis, "Expected `)`");
+					else
+						CompilerSuite::Error(GetLocation(), "Failed to retrieve a valid expression");
+				}
+				else if (!value.has_value())
 				{
-					elif->Scope = scope.value();
-					elif->Next = ParseConditionBrach(); // Note: Can be NULL
-					return Node::ConditionBranch::New(elif);
+					// Note: A missing left hand side fails the expression, a
+					// missing right hand side leaves what we have so far.
+					if (frame.FrameState == ExpressionFrame::State::RHS)
+					{
+						CompilerSuite::Error(GetLocation(), "Unable to parse expression.");
+						value = frame.LHS;
+						constant = frame.LHSValue;
+					}
+
+					m_Expressions.pop_back();
 				}
 				else
-					CompilerSuite::Error(GetLineNumber(), "Failed to retrieve valid scope.");
-			}
-			else
-				CompilerSuite::Error(GetLineNumber(), "Invalid expression.");
+				{
+					if (frame.FrameState == ExpressionFrame::State::LHS)
+					{
+						frame.LHS = value.value();
+						frame.LHSValue = constant;
+					}
+					else
+					{
+						// Note: One node per operator, the type follows from both operands.
+						const Node::BinaryOperator& operation = Node::GetBinaryOperator(frame.Operation);
+						const bool logical = (frame.Operation == Node::BinaryExpr::Type::LogicalAnd || frame.Operation == Node::BinaryExpr::Type::LogicalOr);
+
+						// Note: An operator on two integer constants is typed from its exact value instead of the left operand,
+						// so `60 * 60 * 1000` doesn't wrap around in the type of 60. The operands are cast to that type, which
+						// only keeps the result exact for a division if they fit as well. If the value doesn't fit in 64 bits
+						// it's done in 64 bits.
+						const std::array<ConstantValue, 2> operands = { frame.LHSValue, constant };
+						const ValueType operandType = (logical ? ValueType::None : ValueTypeSmallest(operands));
+
+						ValueType type = ValueType::None;
+						ConstantValue result = {};
+						if (operandType != ValueType::None && operation.Comparison)
+						{
+							AdaptLiteral(*m_Program, frame.LHS, operandType);
+							AdaptLiteral(*m_Program, value.value(), operandType);
+
+							type = ValueType::Bool;
+						}
+						else if (operandType != ValueType::None)
+						{
+							result = Node::EvaluateExact(frame.Operation, frame.LHSValue, constant);
+
+							const std::array<ConstantValue, 3> values = { result, frame.LHSValue, constant };
+							if (result.Type != ValueType::None)
+								type = ValueTypeSmallest(std::span<const ConstantValue>(values).first((frame.Operation == Node::BinaryExpr::Type::Division) ? 3 : 1));
+							else
+								type = (ValueTypeIsSigned(operandType) ? ValueType::Int64 : ValueType::UInt64);
+						}
+						else
+						{
+							if (m_Program->GetKind(value.value()) == Node::Expression::Kind::Literal)
+								AdaptLiteral(*m_Program, value.value(), m_Program->GetType(frame.LHS));
+							else
+								AdaptLiteral(*m_Program, frame.LHS, m_Program->GetType(value.value()));
+
+							type = (operation.Comparison ? ValueType::Bool : ValueTypePromote(m_Program->GetType(frame.LHS), m_Program->GetType(value.value())));
+						}
+
+						frame.LHS = m_Program->AddBinary(type, { frame.Operation, frame.LHS, value.value() });
+						frame.LHSValue = result;
+					}
 
-			CheckConsume(TokenType::CloseParenthesis, "Expected `)`.");
+					// Note: It stops and just returns the normal expression if
+					// it's not a binary expression (that binds tight enough).
+					const Node::BinaryOperator& operation = Node::GetBinaryOperator(static_cast<Node::BinaryExpr::Type>(PeekType(0)));
+					if (operation.Power != 0 && operation.Power >= frame.MinimumPower)
+					{
+						frame.FrameState = ExpressionFrame::State::RHS;
+						frame.Operation = static_cast<Node::BinaryExpr::Type>(Consume().Type);
 
-			return {};
+						// Note: A left associative operator doesn't continue its own right hand side.
+						const uint8_t rhsPower = (operation.Assoc == Node::Associativity::Left ? static_cast<uint8_t>(operation.Power + 1) : operation.Power);
+						m_Expressions.push_back({ .MinimumPower = rhsPower });
+						needsTerm = true;
+					}
+					else
+					{
+						// Note: This is either a binary expression or just a normal expression.
+						value = frame.LHS;
+						constant = frame.LHSValue;
+						m_Expressions.pop_back();
+					}
+				}
+
+				if (m_Expressions.size() == base)
+					return value;
+			}
 		}
-		else if (PeekCheck(0, TokenType::Else)) 
-		{
-			Consume(); // 'else' token
+	}
 
-			if (auto scope = ParseScope()) 
-				return Node::ConditionBranch::New(Node::ElseBranch::New(scope.value()));
-			else 
-				CompilerSuite::Error(GetLineNumber(), "Failed to retrieve valid scope.");
+	std::optional<Node::Reference<Node::Statement>> Parser::ParseStatement()
+	{
+		// Note: Scopes are parsed with an explicit stack (m_Scopes) instead of recursion, the
+		// statement is done once all scopes it opened are closed again. The statements of all
+		// open scopes are collected on m_StatementStack, so every scope can be stored contiguously.
+		const size_t base = m_Scopes.size();
 
-			return {};
-		}
+		Node::Reference<Node::Statement> statement = {};
+		const StatementResult result = ParseScopes(base, BeginStatement(statement), statement);
+
+		if (result == StatementResult::Done)
+			return statement;
 
 		return {};
 	}
 
-	std::optional<Node::Reference<Node::Statement>> Parser::ParseStatement()
+	/////////////////////////////////////////////////////////////////
+	// Statement steps
+	/////////////////////////////////////////////////////////////////
+	Parser::StatementResult Parser::BeginStatement(Node::Reference<Node::Statement>& statement)
 	{
 		/////////////////////////////////////////////////////////////////
 		// Exit statement (Enforces UInt8 expr :) ) 
@@ -218,34 +503,38 @@ namespace Dynamite
 			Consume(); // Exit token
 			Consume(); // '(' token
 
-			Node::Reference<Node::ExitStatement> exitStatement = Node::ExitStatement::New();
+			Node::Reference<Node::Expression> exitExpr = {};
 
 			// Expression resolution
 			if (auto expr = ParseExpr())
 			{
 				// Enforce Int32 type
-				if (!ValueTypeCastable(expr.value()->Type, ValueType::UInt8))
+				// Note: An expression without a type has already been reported, like an undeclared identifier.
+				const ValueType exprType = m_Program->GetType(expr.value());
+				if (exprType == ValueType::None || !ValueTypeCastable(exprType, ValueType::UInt8))
 				{
-					CompilerSuite::Error(GetLineNumber(), "exit() expects an u8 type, got {0}, {0} is not castable to u8", ValueTypeToStr(expr.value()->Type));
+					if (exprType != ValueType::None)
+						CompilerSuite::Error(GetLocation(), "exit() expects an u8 type, got {0}, {0} is not castable to u8", ValueTypeToStr(exprType));
 
 					// Close parenthesis ')' & semicolon `;` resolution
 					CheckConsume(TokenType::CloseParenthesis, "Expected `)`.");
 					CheckConsume(TokenType::Semicolon, "Expected `;`.");
-					return {};
+					return StatementResult::Failed;
 				}
 				
 				// Note: Only casts if the internal type is a literalterm
-				CastInternalValue(expr.value()->Type, ValueType::UInt8, expr.value());
-				exitStatement->ExprObj = expr.value();
+				CastInternalValue(exprType, ValueType::UInt8, expr.value());
+				exitExpr = expr.value();
 			}
 			else
-				CompilerSuite::Error(GetLineNumber(), "Invalid expression.");
+				CompilerSuite::Error(GetLocation(), "Invalid expression.");
 
 			// Close parenthesis ')' & semicolon `;` resolution
 			CheckConsume(TokenType::CloseParenthesis, "Expected `)`.");
 			CheckConsume(TokenType::Semicolon, "Expected `;`.");
 
-			return Node::Statement::New(exitStatement);
+			statement = m_Program->AddExit(exitExpr);
+			return StatementResult::Done;
 		}
 
 		/////////////////////////////////////////////////////////////////
@@ -253,10 +542,10 @@ namespace Dynamite
 		/////////////////////////////////////////////////////////////////
 		else if (PeekCheck(0, TokenType::OpenCurlyBrace))
 		{
-			if (auto scope = ParseScope()) 
-				return Node::Statement::New(scope.value());
+			if (OpenScope(ScopeKind::Scope)) 
+				return StatementResult::Opened;
 			else
-				CompilerSuite::Error(GetLineNumber(), "Invalid scope.");
+				CompilerSuite::Error(GetLocation(), "Invalid scope.");
 		}
 
 		/////////////////////////////////////////////////////////////////
@@ -268,25 +557,22 @@ namespace Dynamite
 
 			if (auto expr = ParseExpr()) 
 			{
-				auto ifStatement = Node::IfStatement::New(expr.value());
-
 				CheckConsume(TokenType::CloseParenthesis, "Expected `)`.");
 			
-				if (auto scope = ParseScope())
-				{
-					ifStatement->Scope = scope.value();
-					ifStatement->Next = ParseConditionBrach(); // Note: Can be NULL
-					return Node::Statement::New(ifStatement);
-				}
-				else
-					CompilerSuite::Error(GetLineNumber(), "Failed to retrieve valid scope.");
+				// Note: The rest of the if statement is created in EndScope().
+				m_Conditions.push_back({ ScopeKind::If, expr.value() });
+				if (OpenScope(ScopeKind::If))
+					return StatementResult::Opened;
+
+				m_Conditions.pop_back();
+				CompilerSuite::Error(GetLocation(), "Failed to retrieve valid scope.");
 			}
 			else 
-				CompilerSuite::Error(GetLineNumber(), "Invalid expression.");
+				CompilerSuite::Error(GetLocation(), "Invalid expression.");
 			
 			CheckConsume(TokenType::CloseParenthesis, "Expected `)`.");
 
-			return {};
+			return StatementResult::Failed;
 		}
 
 		/////////////////////////////////////////////////////////////////
@@ -297,38 +583,47 @@ namespace Dynamite
 			Token typeToken = Consume(); // Type token
 			ValueType variableType = static_cast<ValueType>(typeToken.Type);
 
-			Node::Reference<Node::VariableStatement> variable = Node::VariableStatement::New(variableType, Consume()); // Identifier token
+			// Note: Lazy bodies see the top level variables declared before them.
+			if (m_Lazy && !m_Stream && m_Scopes.empty())
+				m_TopLevelTokens.push_back(m_Index - 1);
+
+			Token identifier = Consume(); // Identifier token
+			Node::VariableStatement variable = { variableType, identifier.Symbol, identifier.Location };
 
-			std::string varName = variable->TokenObj.Value.value();
+			std::string_view varName = identifier.Value;
 
 			// Add type to current scope with name of variable
-			PushVar(varName, variableType);
+			PushVar(variable.Symbol, variableType);
 
 			Consume(); // '=' token
 
 			// Expression resolution
 			if (auto expr = ParseExpr())
 			{
-				if (!ValueTypeCastable(expr.value()->Type, variableType))
+				// Note: An expression without a type has already been reported, like an undeclared identifier.
+				const ValueType exprType = m_Program->GetType(expr.value());
+				if (exprType == ValueType::None || !ValueTypeCastable(exprType, variableType))
 				{
-					CompilerSuite::Error(GetLineNumber(), "Variable creation of \"{0}\" expects expression of type: {1}, but got {2}, {2} is not castable to {1}.", varName, ValueTypeToStr(variableType), ValueTypeToStr(expr.value()->Type));
+					if (exprType != ValueType::None)
+						CompilerSuite::Error(GetLocation(), "Variable creation of \"{0}\" expects expression of type: {1}, but got {2}, {2} is not castable to {1}.", varName, ValueTypeToStr(variableType), ValueTypeToStr(exprType));
 
 					// Semicolon `;` resolution
 					CheckConsume(TokenType::Semicolon, "Expected `;`.");
-					return {};
+					return StatementResult::Failed;
 				}
 
 				// Note: Only casts if the internal type is a literalterm
-				CastInternalValue(expr.value()->Type, variableType, expr.value());
-				variable->ExprObj = expr.value();
+				CastInternalValue(exprType, variableType, expr.value());
+				variable.ExprObj = expr.value();
 			}
 			else
-				CompilerSuite::Error(GetLineNumber(), "Invalid expression.");
+				CompilerSuite::Error(GetLocation(), "Invalid expression.");
 
 			// Semicolon ';' resolution
 			CheckConsume(TokenType::Semicolon, "Expected `;`.");
 
-			return Node::Statement::New(variable);
+			statement = m_Program->AddVariable(variable);
+			return StatementResult::Done;
 		}
 
 		/////////////////////////////////////////////////////////////////
@@ -336,56 +631,290 @@ namespace Dynamite
 		/////////////////////////////////////////////////////////////////
 		if (PeekCheck(0, TokenType::Identifier) && PeekCheck(1, TokenType::Equals)) 
 		{
-			auto assignment = Node::AssignmentStatement::New(Consume());
+			Token identifier = Consume();
+			Node::AssignmentStatement assignment = { identifier.Symbol, identifier.Location };
+
+			// Note: Reports the variable if it hasn't been declared.
+			const ValueType variableType = GetVar(identifier.Symbol).Type;
 			Consume(); // '=' char
 
 			if (auto expr = ParseExpr()) 
 			{
-				assignment->ExprObj = expr.value();
+				// Note: An undeclared variable or an expression without a type has already been reported.
+				const ValueType exprType = m_Program->GetType(expr.value());
+				if (variableType == ValueType::None || exprType == ValueType::None || !ValueTypeCastable(exprType, variableType))
+				{
+					if (variableType != ValueType::None && exprType != ValueType::None)
+						CompilerSuite::Error(GetLocation(), "Assignment to \"{0}\" expects expression of type: {1}, but got {2}, {2} is not castable to {1}.", identifier.Value, ValueTypeToStr(variableType), ValueTypeToStr(exprType));
+
+					// Semicolon `;` resolution
+					CheckConsume(TokenType::Semicolon, "Expected `;`.");
+					return StatementResult::Failed;
+				}
+
+				// Note: Only casts if the internal type is a literalterm
+				CastInternalValue(exprType, variableType, expr.value());
+				assignment.ExprObj = expr.value();
 				CheckConsume(TokenType::Semicolon, "Expected `;`.");
-				return Node::Statement::New(assignment);
+
+				statement = m_Program->AddAssignment(assignment);
+				return StatementResult::Done;
 			}
 			else 
-				CompilerSuite::Error(GetLineNumber(), "Invalid expression.");
+				CompilerSuite::Error(GetLocation(), "Invalid expression.");
 
-			return {};
+			return StatementResult::Failed;
 		}
 
 		// Consume() just 1 token, just to make sure we keep going.
 		// Since obviously from the previous token it was impossible to carry on.
 		Consume();
+		return StatementResult::Failed;
+	}
+
+	Parser::StatementResult Parser::ParseScopes(size_t base, StatementResult result, Node::Reference<Node::Statement>& statement)
+	{
+		while (m_Scopes.size() > base)
+		{
+			switch (result)
+			{
+			case StatementResult::Done:
+				m_StatementStack.push_back(statement);
+				[[fallthrough]];
+			case StatementResult::Opened:
+				result = BeginStatement(statement);
+				break;
+
+			// Note: A scope ends at the first statement that isn't valid, normally the `}`.
+			case StatementResult::Failed:
+				result = EndScope(statement);
+				break;
+			}
+		}
+
+		return result;
+	}
+
+	Parser::StatementResult Parser::EndScope(Node::Reference<Node::Statement>& statement)
+	{
+		// Note: We decrement, since if we did not retrieve any (valid) statements
+		// it will result in consuming the next token just to carry on, but this also means
+		// that the '}' has already been consumed. So we just go one back.
+		m_Index--;
+
+		m_Variables.PopScope();
+		
+		CheckConsume(TokenType::CloseCurlyBrace, "Expected `}}`");
+
+		const ScopeFrame frame = m_Scopes.back();
+		m_Scopes.pop_back();
+
+		Node::Reference<Node::ScopeStatement> scope = (frame.Lazy ? m_Program->AddLazyScope(static_cast<uint32_t>(frame.Begin)) : m_Program->AddScopeBody(m_StatementStack.data() + frame.FirstStatement, m_StatementStack.size() - frame.FirstStatement));
+		m_StatementStack.resize(frame.FirstStatement);
+
+		if (frame.Kind == ScopeKind::Scope)
+		{
+			statement = m_Program->AddScope(scope);
+			return StatementResult::Done;
+		}
+		else if (frame.Kind == ScopeKind::Body)
+		{
+			m_Body = scope;
+			return StatementResult::Done;
+		}
+
+		m_Conditions.back().Scope = scope;
+		if (frame.Kind == ScopeKind::Else)
+		{
+			statement = EndConditionChain();
+			return StatementResult::Done;
+		}
+
+		return ParseConditionBrach(statement);
+	}
+
+	Parser::StatementResult Parser::ParseConditionBrach(Node::Reference<Node::Statement>& statement)
+	{
+		if (PeekCheck(0, TokenType::Else) && PeekCheck(1, TokenType::If)) 
+		{
+			Consume(); // 'else' token
+			Consume(); // 'if' token
+
+			CheckConsume(TokenType::OpenParenthesis, "Expected `(`.");
+
+			if (auto expr = ParseExpr())
+			{
+				CheckConsume(TokenType::CloseParenthesis, "Expected `)`.");
+
+				m_Conditions.push_back({ ScopeKind::ElseIf, expr.value() });
+				if (OpenScope(ScopeKind::ElseIf))
+					return StatementResult::Opened;
+
+				m_Conditions.pop_back();
+				CompilerSuite::Error(GetLocation(), "Failed to retrieve valid scope.");
+			}
+			else
+				CompilerSuite::Error(GetLocation(), "Invalid expression.");
+
+			CheckConsume(TokenType::CloseParenthesis, "Expected `)`.");
+		}
+		else if (PeekCheck(0, TokenType::Else)) 
+		{
+			Consume(); // 'else' token
+
+			m_Conditions.push_back({ ScopeKind::Else });
+			if (OpenScope(ScopeKind::Else))
+				return StatementResult::Opened;
+
+			m_Conditions.pop_back();
+			CompilerSuite::Error(GetLocation(), "Failed to retrieve valid scope.");
+		}
+
+		// Note: There is no (valid) next branch, so the chain is done.
+		statement = EndConditionChain();
+		return StatementResult::Done;
+	}
+
+	bool Parser::OpenScope(ScopeKind kind)
+	{
+		if (!TryConsume(TokenType::OpenCurlyBrace).has_value())
+			return false;
+
+		if (m_Scopes.size() >= m_MaxNesting)
+		{
+			CompilerSuite::Error(GetLocation(), "Scope nesting exceeds the maximum depth of {0}.", m_MaxNesting);
+
+			// Note: Skips the contents of the scope, the `}` is left so
+			// the (empty) scope is closed like any other scope.
+			size_t depth = 0;
+			while (true)
+			{
+				const TokenType current = PeekType(0);
+				if (current == TokenType::None || (current == TokenType::CloseCurlyBrace && depth == 0))
+					break;
+
+				if (current == TokenType::OpenCurlyBrace)
+					depth++;
+				else if (current == TokenType::CloseCurlyBrace)
+					depth--;
+
+				Consume();
+			}
+		}
+
+		ScopeFrame frame = { kind, m_StatementStack.size() };
+
+		// Note: A lazy top level scope is skipped up to its `}`, which is consumed like any other `}`.
+		// Without a matching `}` the scope is parsed, so the errors are the same.
+		if (m_Lazy && !m_Stream && m_Scopes.empty())
+		{
+			if (auto end = FindScopeEnd(m_Index - 1))
+			{
+				frame.Lazy = true;
+				frame.Begin = m_Index - 1;
+				m_Index = end.value();
+			}
+		}
+
+		m_Variables.PushScope();
+		m_Scopes.push_back(frame);
+		return true;
+	}
+
+	std::optional<size_t> Parser::FindScopeEnd(size_t index) const
+	{
+		size_t depth = 0;
+		for (size_t i = index; i < m_Tokens.Size(); i++)
+		{
+			const TokenType type = m_Tokens.GetType(i);
+			if (type == TokenType::OpenCurlyBrace)
+				depth++;
+			else if (type == TokenType::CloseCurlyBrace && --depth == 0)
+				return i;
+		}
+
 		return {};
 	}
 
+	Node::Reference<Node::Statement> Parser::EndConditionChain()
+	{
+		// Note: The chain is created back to front, since every branch refers to the next.
+		Node::Reference<Node::ConditionBranch> next = {};
+		while (m_Conditions.back().Kind != ScopeKind::If)
+		{
+			const ConditionFrame branch = m_Conditions.back();
+			m_Conditions.pop_back();
+
+			if (branch.Kind == ScopeKind::Else)
+				next = m_Program->AddElse(branch.Scope);
+			else
+				next = m_Program->AddElseIf({ branch.ExprObj, branch.Scope, next });
+		}
+
+		const ConditionFrame ifBranch = m_Conditions.back();
+		m_Conditions.pop_back();
+
+		return m_Program->AddIf({ ifBranch.ExprObj, ifBranch.Scope, next });
+	}
+
 	/////////////////////////////////////////////////////////////////
 	// Peeking & consuming
 	/////////////////////////////////////////////////////////////////
 	std::optional<Token> Parser::Peek(size_t offset) const
 	{
-		if (m_Index + offset >= m_Tokens.size())
+		const size_t index = m_Index + offset;
+		if (m_Stream)
+			return (Fill(index) ? std::optional<Token>(m_Window[index % s_WindowSize]) : std::nullopt);
+
+		if (index >= m_Tokens.Size())
 			return {};
 
-		return m_Tokens.at(m_Index + offset);
+		return m_Tokens.Get(index);
+	}
+
+	TokenType Parser::PeekType(size_t offset) const
+	{
+		const size_t index = m_Index + offset;
+		if (m_Stream)
+			return (Fill(index) ? m_Window[index % s_WindowSize].Type : TokenType::None);
+
+		if (index >= m_Tokens.Size())
+			return TokenType::None;
+
+		return m_Tokens.GetType(index);
 	}
 
 	Token Parser::Consume()
 	{
-		return m_Tokens.at(m_Index++);
+		if (m_Stream)
+		{
+			const size_t index = m_Index++;
+			return (Fill(index) ? m_Window[index % s_WindowSize] : Token());
+		}
+
+		// Note: Scopes that are still open at the end of the file consume past the end.
+		if (m_Index >= m_Tokens.Size())
+		{
+			m_Index++;
+			return {};
+		}
+
+		return m_Tokens.Get(m_Index++);
 	}
 
-	Token Parser::CheckConsume(TokenType tokenType, const std::string& msg)
+	Token Parser::CheckConsume(TokenType tokenType, std::string_view msg)
 	{
 		if (PeekCheck(0, tokenType))
 			return Consume();
 		else if (!msg.empty())
-			CompilerSuite::Error(GetLineNumber(), msg);
+			CompilerSuite::Error(GetLocation(), std::string(msg));
 
 		return {};
 	}
 
 	std::optional<Token> Parser::TryConsume(TokenType type)
 	{
-		if (Peek(0).has_value() && Peek(0).value().Type == type)
+		if (PeekCheck(0, type))
 			return Consume();
 			
 		return {};
@@ -393,74 +922,55 @@ namespace Dynamite
 
 	std::optional<Token> Parser::TryConsumeLiteral()
 	{
-		if (PeekIs({
-				TokenType::BoolLiteral,
-				TokenType::IntegerLiteral,
-				TokenType::FloatLiteral,
-				TokenType::CharLiteral,
-				TokenType::StringLiteral
-			}))
-		{
+		if (PeekIs(s_LiteralTokens))
 			return Consume();
-		}
 
 		return {};
 	}
 
-	bool Parser::PeekIs(const std::vector<TokenType>& allowedValues)
+	const ConstantValue& Parser::GetConstant(size_t index) const
 	{
-		std::optional<Token> peek = Peek(0);
-		if (!peek.has_value())
-			return false;
+		if (m_Stream)
+			return m_WindowConstants[index % s_WindowSize];
 
-		TokenType type = peek.value().Type;
-		
-		for (const auto& allowed : allowedValues)
-		{
-			if (type == allowed)
-				return true;
-		}
-
-		return false;
+		return m_Tokens.GetConstant(index);
 	}
 
-	// Note: Has to be manually updated
-	bool Parser::PeekIsValueType()
+	bool Parser::Fill(size_t index) const
 	{
-		return PeekIs({
-			TokenType::Bool, 
+		// Note: Tokens that have already been pulled are available as long
+		// as they haven't been overwritten, new tokens only up to a window ahead.
+		// This also rejects m_Index + (size_t)-1 at the start.
+		if (index < m_WindowEnd)
+			return (m_WindowEnd - index <= s_WindowSize);
+		if (index - m_WindowEnd >= s_WindowSize)
+			return false;
 
-			TokenType::Int8,
-			TokenType::Int16,
-			TokenType::Int32,
-			TokenType::Int64,
+		while (m_WindowEnd <= index)
+		{
+			const size_t slot = m_WindowEnd % s_WindowSize;
+			if (!m_Stream->Next(m_Window[slot], m_WindowConstants[slot]))
+				return false;
 
-			TokenType::UInt8,
-			TokenType::UInt16,
-			TokenType::UInt32,
-			TokenType::UInt64,
+			m_WindowEnd++;
+		}
 
-			TokenType::Float32,
-			TokenType::Float64,
+		return true;
+	}
 
-			TokenType::Char,
-			TokenType::String
-		});
+	bool Parser::PeekIs(const TokenTypeSet& allowedValues) const
+	{
+		return allowedValues.Contains(PeekType(0));
 	}
 
-	// Note: Has to be manually updated
-	bool Parser::PeekIsBinaryOperator()
+	bool Parser::PeekIsValueType() const
 	{
-		return PeekIs({
-			TokenType::Add,
-			TokenType::Subtract,
-			TokenType::Multiply,
-			TokenType::Divide,
+		return PeekIs(s_ValueTypeTokens);
+	}
 
-			TokenType::Or,
-			TokenType::And,
-			TokenType::Xor
-		});
+	bool Parser::PeekIsBinaryOperator() const
+	{
+		return Node::GetBinaryOperator(static_cast<Node::BinaryExpr::Type>(PeekType(0))).Power != 0;
 	}
 
 	// Note: Only casts if the internal type is a literalterm
@@ -469,54 +979,60 @@ namespace Dynamite
 		if (from == to)
 			return;
 
-		bool dataLost = false;
-		std::string originalData = Node::FormatExpressionData(expression);
-		std::visit([&, from, to](auto&& obj) -> bool
-		{
-			if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Node::Reference<Node::TermExpr>>)
-			{
-				std::visit([&, from, to](auto&& obj) -> void
-				{
-					if constexpr (Pulse::Types::Same<Pulse::Types::Clean<decltype(obj)>, Node::Reference<Node::LiteralTerm>>)
-					{
-						obj->TokenObj.Value = ValueTypeCast(from, to, obj->TokenObj.Value.value(), &dataLost);
-					}
+		if (m_Program->GetKind(expression) != Node::Expression::Kind::Literal)
+			return;
 
-				}, obj->TermObj);
-			}
+		Node::LiteralTerm& literal = m_Program->GetLiteral(expression);
+
+		// Note: Converted like the generated code would, so out of range integers wrap around.
+		const std::optional<ConstantValue> converted = ValueTypeConvert(to, literal.Value);
+		if (!converted.has_value())
+			return;
 
-			return dataLost;
-		}, expression->ExprObj);
+		const ConstantValue value = converted.value();
 
-		if (dataLost) // Note: This outputs the new value, not the original value before cast
-			CompilerSuite::Warn(GetLineNumber(), "Lost data while casting expression. From: {0}, to {1}\n    Original: \t\t{2}\n    New: \t\t{3}", ValueTypeToStr(from), ValueTypeToStr(to), originalData, Node::FormatExpressionData(expression));
+		// Note: The expression is only formatted when the warning is actually needed. Every value converts exactly to bool.
+		if (to != ValueType::Bool && !ValueTypeFits(to, literal.Value))
+		{
+			std::string originalData = Node::FormatExpressionData(*m_Program, expression);
+			literal.Value = value;
+
+			CompilerSuite::Warn(GetLocation(), "Lost data while casting expression. From: {0}, to {1}\n    Original: \t\t{2}\n    New: \t\t{3}", ValueTypeToStr(from), ValueTypeToStr(to), originalData, Node::FormatExpressionData(*m_Program, expression));
+		}
+		else
+			literal.Value = value;
 	}
 
-	void Parser::PushVar(const std::string& name, ValueType type)
+	void Parser::PushVar(SymbolId symbol, ValueType type)
 	{
-		m_Variables.emplace_back(name, type);
+		m_Variables.Push(symbol, { symbol, type });
 	}
 
 	void Parser::PopVar(size_t count)
 	{
-		for (size_t i = 0; i < count; i++)
-			m_Variables.pop_back();
+		m_Variables.Pop(count);
 	}
 
-	Variable Parser::GetVar(const std::string& name)
+	Variable Parser::GetVar(SymbolId symbol)
 	{
-		const auto it = std::ranges::find_if(std::as_const(m_Variables), [&](const Variable& var) 
+		const Variable* variable = m_Variables.Find(symbol);
+		if (!variable && m_Declarations && symbol + 1 < m_Declarations->Offsets.size())
 		{
-			return var.Name == name;
-		});
+			// Note: The last top level declaration before the range.
+			const auto begin = m_Declarations->Items.begin() + m_Declarations->Offsets[symbol];
+			const auto end = m_Declarations->Items.begin() + m_Declarations->Offsets[symbol + 1];
+			const auto declaration = std::partition_point(begin, end, [this](const Declaration& declaration) { return declaration.Index < m_RangeBegin; });
+			if (declaration != begin)
+				return { symbol, (declaration - 1)->Type };
+		}
 
-		if (it == m_Variables.cend())
+		if (!variable)
 		{
-			CompilerSuite::Error(GetLineNumber(), "Undeclared identifier: {0}", name);
+			CompilerSuite::Error(GetLocation(), "Undeclared identifier: {0}", m_Tokens.GetSymbols().GetName(symbol));
 			return {};
 		}
 	
-		return *it;
+		return *variable;
 	}
 
 }
\ No newline at end of file
@@ -1,70 +1,221 @@
 #pragma once
 
+#include "Dynamite/Core/Arena.hpp"
+#include "Dynamite/Core/SymbolTable.hpp"
+#include "Dynamite/Core/ThreadPool.hpp"
+
 #include "Dynamite/Tokens/Token.hpp"
+#include "Dynamite/Tokens/TokenStream.hpp"
 
 #include "Dynamite/Parsing/Nodes.hpp"
 
-#include <Pulse/Memory/ArenaAllocator.hpp>
+#include <Pulse/Core/Unique.hpp>
 
+#include <array>
 #include <cstdint>
 #include <vector>
 #include <optional>
+#include <string_view>
 #include <unordered_map>
 
 namespace Dynamite
 {
 
-	class Parser
+	class Tokenizer;
+
+	class Parser : public Node::BodyParser
 	{
 	public:
-		Parser(std::vector<Token>& tokens);
+		// Note: The default nesting limit of parentheses & scopes.
+		constexpr static const size_t DefaultMaxNesting = 256;
+	public:
+		// Note: A lazy parser only records the tokens of top level scope bodies, a body is parsed when
+		// it's expanded through the Program. Lazy parsing doesn't apply while streaming.
+		Parser(TokenStream& tokens, ThreadPool& threadPool, size_t maxNesting = DefaultMaxNesting, bool lazy = false);
 		~Parser() = default;
 
+		// Note: Large files are split into ranges of top level statements
+		// which are parsed in parallel, the result is the same.
+		// With lazy parsing the Parser & its TokenStream must outlive the Program.
 		Node::Program GetProgram();
+		// Note: Pulls the tokens from the tokenizer while parsing instead of reading
+		// them from the TokenStream, the tokenizer must be started with BeginStream().
+		Node::Program GetProgram(Tokenizer& stream);
 
-		inline const std::vector<Token>& GetTokens() const { return m_Tokens; }
+		inline const TokenStream& GetTokens() const { return m_Tokens; }
 		inline const size_t GetIndex() const { return m_Index; }
 
 	public:
-		std::optional<Node::Reference<Node::TermExpr>> ParseTermExpr();
-		std::optional<Node::Reference<Node::Expression>> ParseExpr(const size_t minimumPrecedence = 0);
-		std::optional<Node::Reference<Node::ScopeStatement>> ParseScope();
-		std::optional<Node::Reference<Node::ConditionBranch>> ParseConditionBrach();
+		// Note: Only parses literals & identifiers, parentheses are handled by ParseExpr().
+		std::optional<Node::Reference<Node::Expression>> ParseTermExpr();
+		// Note: Only parses operators that bind at least as tight as minimumPower.
+		std::optional<Node::Reference<Node::Expression>> ParseExpr(const uint8_t minimumPower = 0);
 		std::optional<Node::Reference<Node::Statement>> ParseStatement();
 
+		inline size_t GetMaxNesting() const { return m_MaxNesting; }
+		inline bool IsLazy() const { return m_Lazy; }
+
+		// Note: Parses a lazy scope body, with the top level variables declared before it in scope.
+		Node::Reference<Node::ScopeStatement> ParseBody(Node::Program& program, uint32_t index) override;
+
 	public:
 		// Returns the Token at m_Index + offset, if it is out of bounds it
 		// will return an optional with no value. Checkable with .has_value()
 		[[nodiscard]] std::optional<Token> Peek(size_t offset = 0) const;
+		// Returns the type of the Token at m_Index + offset, TokenType::None if it is out of bounds.
+		// Note: Prefer this over Peek() when only the type is needed.
+		[[nodiscard]] TokenType PeekType(size_t offset = 0) const;
+		[[nodiscard]] inline bool PeekCheck(size_t offset, TokenType type) const { return PeekType(offset) == type; }
+
+	private:
+		// Parses the top level statements that start in [begin, end).
+		Node::Program GetProgram(size_t begin, size_t end);
+		// Returns an empty optional if the ranges couldn't be parsed independently.
+		std::optional<Node::Program> GetProgramParallel();
+
+		// Groups the declarations at m_TopLevelTokens into m_TopLevel.
+		void SetTopLevel();
+
+	private:
+		enum class ScopeKind : uint8_t { Scope, If, ElseIf, Else, Body };
+		enum class StatementResult : uint8_t { Done, Failed, Opened };
+
+		// Note: These are the steps of ParseStatement(), a step that opens a scope returns
+		// StatementResult::Opened and the scope is continued by the next steps.
+		StatementResult BeginStatement(Node::Reference<Node::Statement>& statement);
+		StatementResult EndScope(Node::Reference<Node::Statement>& statement);
+		StatementResult ParseConditionBrach(Node::Reference<Node::Statement>& statement);
+		// Continues with the steps until all scopes above base are closed.
+		StatementResult ParseScopes(size_t base, StatementResult result, Node::Reference<Node::Statement>& statement);
+
+		// Returns false if there is no `{`.
+		bool OpenScope(ScopeKind kind);
+		// Returns the index of the `}` that closes the `{` at index, an empty optional if it's never closed.
+		std::optional<size_t> FindScopeEnd(size_t index) const;
+		// Creates the if statement of the innermost condition chain.
+		Node::Reference<Node::Statement> EndConditionChain();
 
 	private:
 		// Increments the index and returns the Token at m_Index
 		Token Consume();
-		Token CheckConsume(TokenType tokenType, const std::string& msg = {});
+		Token CheckConsume(TokenType tokenType, std::string_view msg = {});
 		std::optional<Token> TryConsume(TokenType type);
 
 		std::optional<Token> TryConsumeLiteral();
 
-		bool PeekIs(const std::vector<TokenType>& allowedValues);
-		bool PeekIsValueType();
-		bool PeekIsBinaryOperator();
+		// Returns the decoded value of the literal at index.
+		const ConstantValue& GetConstant(size_t index) const;
+		// Makes sure the token at index is in the window, returns false if it's not available.
+		bool Fill(size_t index) const;
+
+		bool PeekIs(const TokenTypeSet& allowedValues) const;
+		bool PeekIsValueType() const;
+		bool PeekIsBinaryOperator() const;
 
 		// Note: Only casts if the internal type is a literalterm
 		void CastInternalValue(ValueType from, ValueType to, Node::Reference<Node::Expression> expression);
 
-		inline uint32_t GetLineNumber() const { return (Peek(0).has_value() ? Peek(0).value().LineNumber : Peek(-1).value().LineNumber); }
+		inline SourceLocation GetLocation() const { return (Peek(0).has_value() ? Peek(0).value().Location : Peek(-1).value().Location); }
 
 	private:
-		void PushVar(const std::string& name, ValueType type);
+		void PushVar(SymbolId symbol, ValueType type);
 		void PopVar(size_t count);
-		Variable GetVar(const std::string& name);
+		Variable GetVar(SymbolId symbol);
 
 	private:
-		std::vector<Token>& m_Tokens;
+		TokenStream& m_Tokens;
+		ThreadPool& m_ThreadPool;
 		size_t m_Index = 0;
 
-		std::vector<Variable> m_Variables = {};
-		std::vector<size_t> m_Scopes = { 0 };
+		size_t m_MaxNesting;
+		bool m_Lazy;
+
+		// Note: Only set while parsing, the program the nodes are added to.
+		Node::Program* m_Program = nullptr;
+		// Note: The statements of all scopes that are being parsed, so every
+		// scope can be stored contiguously once it's done.
+		std::vector<Node::Reference<Node::Statement>> m_StatementStack = {};
+
+		// Note: Nested expressions & scopes are parsed with these explicit
+		// stacks instead of recursion, so deep nesting can't overflow the stack.
+		struct ExpressionFrame
+		{
+		public:
+			enum class State : uint8_t { LHS, RHS, Parenthesis };
+		public:
+			State FrameState = State::LHS;
+			uint8_t MinimumPower = 0;
+
+			Node::BinaryExpr::Type Operation = Node::BinaryExpr::Type::None;
+			Node::Reference<Node::Expression> LHS = {};
+			ConstantValue LHSValue = {}; // The exact value of LHS if it's an integer constant
+		};
+
+		struct ScopeFrame
+		{
+		public:
+			ScopeKind Kind = ScopeKind::Scope;
+			size_t FirstStatement = 0; // Into m_StatementStack
+
+			// Note: A lazy scope is skipped up to its `}`, Begin is its `{`.
+			bool Lazy = false;
+			size_t Begin = 0;
+		};
+
+		// Note: A branch of an if statement that is being parsed.
+		struct ConditionFrame
+		{
+		public:
+			ScopeKind Kind = ScopeKind::If;
+			Node::Reference<Node::Expression> ExprObj = {};
+			Node::Reference<Node::ScopeStatement> Scope = {};
+		};
+
+		std::vector<ExpressionFrame> m_Expressions = {};
+		std::vector<ScopeFrame> m_Scopes = {};
+		std::vector<ConditionFrame> m_Conditions = {};
+
+		// Note: The result of ParseBody().
+		Node::Reference<Node::ScopeStatement> m_Body = {};
+
+		// Note: Only used while streaming, the window holds the last s_WindowSize tokens
+		// which covers the lookahead (Peek(0..2)) and the tokens we can step back to.
+		constexpr static const size_t s_WindowSize = 8;
+
+		Tokenizer* m_Stream = nullptr;
+		mutable std::array<Token, s_WindowSize> m_Window = { };
+		mutable std::array<ConstantValue, s_WindowSize> m_WindowConstants = { };
+		mutable size_t m_WindowEnd = 0; // Index after the last token pulled
+
+		ScopedSymbolTable<Variable> m_Variables = {};
+
+		// Note: The top level variables of a file that is parsed in parallel, they are
+		// grouped by SymbolId (Offsets[symbol] is the first) and in source order.
+		struct Declaration
+		{
+		public:
+			size_t Index = 0; // Of the type token
+			ValueType Type = ValueType::None;
+		};
+
+		struct Declarations
+		{
+		public:
+			std::vector<uint32_t> Offsets = { };
+			std::vector<Declaration> Items = { };
+		};
+
+		// Note: Only set while parsing a range in parallel or a lazy body, the declarations
+		// before m_RangeBegin are visible after the variables of the range.
+		const Declarations* m_Declarations = nullptr;
+		size_t m_RangeBegin = 0;
+
+		// Note: The top level variables of the last program, lazy bodies are parsed with these.
+		Declarations m_TopLevel = {};
+		std::vector<size_t> m_TopLevelTokens = {}; // Of the type tokens, in source order
+
+		// Note: The arenas of the ranges that are parsed in parallel, kept to be reused.
+		std::vector<Pulse::Unique<Arena>> m_RangeArenas = {};
 	};
 
 }
\ No newline at end of file
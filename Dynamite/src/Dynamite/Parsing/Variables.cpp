@@ -6,13 +6,44 @@
 #include "Dynamite/Tokens/Tokenizer.hpp"
 
 #include <Pulse/Core/Defines.hpp>
+#include <Pulse/Text/Format.hpp>
 
 #undef FMT_VERSION
 #include <Pulse/Enum/Enum.hpp>
 
+#include <bit>
+#include <cmath>
+#include <charconv>
+
 namespace Dynamite
 {
 
+	namespace
+	{
+		// Note: The tokenizer guarantees str is a valid number (floats have no exponent), so the only possible
+		// errors are overflow & for floats underflow. A float below 1 that rounds to 0 hasn't lost any data.
+		template<typename T>
+		static void ParseNumber(std::string_view str, T& value, bool* dataLostPtr)
+		{
+			auto [ptr, error] = std::from_chars(str.data(), str.data() + str.size(), value);
+			if (error == std::errc())
+				return;
+
+			const bool negative = (!str.empty() && str[0] == '-');
+			if constexpr (std::is_floating_point_v<T>)
+			{
+				if (str.substr(0, str.find('.')).find_first_not_of("-0") == std::string_view::npos)
+				{
+					value = (negative ? -static_cast<T>(0) : static_cast<T>(0));
+					return;
+				}
+			}
+
+			if (dataLostPtr) *dataLostPtr = true;
+			value = (negative ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max());
+		}
+	}
+
 	std::string ValueTypeToASM(ValueType type)
 	{
 		switch (type)
@@ -103,6 +134,92 @@ namespace Dynamite
 		return 0;
 	}
 
+	bool ValueTypeIsInteger(ValueType type)
+	{
+		return (type >= ValueType::Int8 && type <= ValueType::UInt64);
+	}
+
+	bool ValueTypeIsUnsigned(ValueType type)
+	{
+		return (type >= ValueType::UInt8 && type <= ValueType::UInt64);
+	}
+
+	bool ValueTypeIsSigned(ValueType type)
+	{
+		return ((type >= ValueType::Int8 && type <= ValueType::Int64) || type == ValueType::Char);
+	}
+
+	bool ValueTypeIsFloat(ValueType type)
+	{
+		return (type == ValueType::Float32 || type == ValueType::Float64);
+	}
+
+	ValueType ValueTypePromote(ValueType lhs, ValueType rhs)
+	{
+		if (lhs == rhs)
+			return lhs;
+
+		const bool lhsNumeric = (ValueTypeIsInteger(lhs) || ValueTypeIsFloat(lhs));
+		const bool rhsNumeric = (ValueTypeIsInteger(rhs) || ValueTypeIsFloat(rhs));
+		if (!lhsNumeric || !rhsNumeric)
+			return lhs;
+
+		if (ValueTypeIsFloat(lhs) || ValueTypeIsFloat(rhs))
+			return ((lhs == ValueType::Float64 || rhs == ValueType::Float64) ? ValueType::Float64 : ValueType::Float32);
+
+		const size_t lhsSize = ValueTypeSize(lhs);
+		const size_t rhsSize = ValueTypeSize(rhs);
+		if (lhsSize != rhsSize)
+			return (lhsSize > rhsSize ? lhs : rhs);
+
+		return (ValueTypeIsUnsigned(lhs) ? rhs : lhs);
+	}
+
+	bool ValueTypeFits(ValueType type, const ConstantValue& value)
+	{
+		const std::optional<ConstantValue> converted = ValueTypeConvert(type, value);
+		if (!converted.has_value())
+			return false;
+
+		// Note: Converting back gives the same bits if nothing was lost.
+		const std::optional<ConstantValue> back = ValueTypeConvert(value.Type, converted.value());
+		if (!back.has_value() || GetConstantBits(back.value()) != GetConstantBits(value))
+			return false;
+
+		// Note: Integers also have to keep their sign, -1 & 255 have the same bits.
+		if (!ValueTypeIsFloat(type) && !ValueTypeIsFloat(value.Type))
+		{
+			const bool negative = (ValueTypeIsSigned(value.Type) && static_cast<int64_t>(GetConstantBits(value)) < 0);
+			const bool convertedNegative = (ValueTypeIsSigned(type) && static_cast<int64_t>(GetConstantBits(converted.value())) < 0);
+			return (negative == convertedNegative);
+		}
+
+		return true;
+	}
+
+	ValueType ValueTypeSmallest(std::span<const ConstantValue> values)
+	{
+		constexpr static const ValueType s_Unsigned[] = { ValueType::UInt8, ValueType::UInt16, ValueType::UInt32, ValueType::UInt64 };
+		constexpr static const ValueType s_Signed[] = { ValueType::Int8, ValueType::Int16, ValueType::Int32, ValueType::Int64 };
+
+		bool isSigned = false;
+		for (const ConstantValue& value : values)
+		{
+			if (!ValueTypeIsInteger(value.Type))
+				return ValueType::None;
+
+			isSigned = isSigned || (ValueTypeIsSigned(value.Type) && value.Int < 0);
+		}
+
+		for (const ValueType type : (isSigned ? std::span<const ValueType>(s_Signed) : std::span<const ValueType>(s_Unsigned)))
+		{
+			if (std::all_of(values.begin(), values.end(), [type](const ConstantValue& value) { return ValueTypeFits(type, value); }))
+				return type;
+		}
+
+		return ValueType::None;
+	}
+
 	bool ValueTypeCastable(ValueType from, ValueType to)
 	{
 		if (from == to)
@@ -121,6 +238,15 @@ namespace Dynamite
 		case Fuse(ValueType::UInt32, ValueType::Bool):		return true;
 		case Fuse(ValueType::UInt64, ValueType::Bool):		return true;
 
+		case Fuse(ValueType::Bool, ValueType::Int8):		return true;
+		case Fuse(ValueType::Bool, ValueType::Int16):		return true;
+		case Fuse(ValueType::Bool, ValueType::Int32):		return true;
+		case Fuse(ValueType::Bool, ValueType::Int64):		return true;
+		case Fuse(ValueType::Bool, ValueType::UInt8):		return true;
+		case Fuse(ValueType::Bool, ValueType::UInt16):		return true;
+		case Fuse(ValueType::Bool, ValueType::UInt32):		return true;
+		case Fuse(ValueType::Bool, ValueType::UInt64):		return true;
+
 		// Int to other Int conversions
 		case Fuse(ValueType::Int8, ValueType::Int16):		return true;
 		case Fuse(ValueType::Int8, ValueType::Int32):		return true;
@@ -185,208 +311,208 @@ namespace Dynamite
 		return false;
 	}
 
-	std::string ValueTypeCast(ValueType from, ValueType to, const std::string& value, bool* dataLostPtr)
+	std::optional<ConstantValue> ValueTypeConvert(ValueType to, const ConstantValue& value)
 	{
-		if (from == to)
+		const ValueType from = value.Type;
+		if (from == to && to != ValueType::Float32)
 			return value;
 
-		using namespace Pulse::Enum;
-		switch (Fuse(from, to))
-		{
-		// Bool conversions
-		case Fuse(ValueType::Int8, ValueType::Bool):		
-		case Fuse(ValueType::Int16, ValueType::Bool):		
-		case Fuse(ValueType::Int32, ValueType::Bool):		
-		case Fuse(ValueType::Int64, ValueType::Bool):		
-		case Fuse(ValueType::UInt8, ValueType::Bool):		
-		case Fuse(ValueType::UInt16, ValueType::Bool):		
-		case Fuse(ValueType::UInt32, ValueType::Bool):		
-		case Fuse(ValueType::UInt64, ValueType::Bool):		
-		{
-			uint64_t uint = std::stoull(value);
-			bool b = static_cast<bool>(uint);
-			return std::to_string(b);
-		}
+		if (from == ValueType::None || from == ValueType::String || to == ValueType::None || to == ValueType::String)
+			return {};
+
+		ConstantValue result = {};
+		result.Type = to;
 
-		// Smaller to larger Int & Uint conversions
-		case Fuse(ValueType::Int8, ValueType::Int16):	
-		case Fuse(ValueType::Int8, ValueType::Int32):	
-		case Fuse(ValueType::Int8, ValueType::Int64):	
-		case Fuse(ValueType::Int16, ValueType::Int32):	
-		case Fuse(ValueType::Int16, ValueType::Int64):	
-		case Fuse(ValueType::Int32, ValueType::Int64):	
-
-		case Fuse(ValueType::UInt8, ValueType::UInt16):	
-		case Fuse(ValueType::UInt8, ValueType::UInt32):	
-		case Fuse(ValueType::UInt8, ValueType::UInt64):	
-		case Fuse(ValueType::UInt16, ValueType::UInt32):
-		case Fuse(ValueType::UInt16, ValueType::UInt64):
-		case Fuse(ValueType::UInt32, ValueType::UInt64):
+		if (to == ValueType::Bool)
 		{
-			return value;
+			// Note: NaN is true.
+			result.Bool = (ValueTypeIsFloat(from) ? !(value.Float == 0.0) : (GetConstantBits(value) != 0));
+			return result;
 		}
 
-		// UInt to Int conversions
-		case Fuse(ValueType::UInt8, ValueType::Int16):
-		case Fuse(ValueType::UInt8, ValueType::Int32):
-		case Fuse(ValueType::UInt8, ValueType::Int64):
-		case Fuse(ValueType::UInt16, ValueType::Int32):
-		case Fuse(ValueType::UInt16, ValueType::Int64):
-		case Fuse(ValueType::UInt32, ValueType::Int64):
+		// Note: A Float32 literal is rounded here, even to Float32, and keeps its exact value as a Float64.
+		if (ValueTypeIsFloat(from) && ValueTypeIsFloat(to))
 		{
-			uint64_t uint = std::stoull(value);
-			int64_t intVal = static_cast<int64_t>(uint);
-			return std::to_string(intVal);
+			result.Float = (to == ValueType::Float32 ? static_cast<double>(static_cast<float>(value.Float)) : value.Float);
+			return result;
 		}
 
-		// Int to UInt conversions
-		case Fuse(ValueType::Int8, ValueType::UInt16):
-		case Fuse(ValueType::Int8, ValueType::UInt32):
-		case Fuse(ValueType::Int8, ValueType::UInt64):
-		case Fuse(ValueType::Int16, ValueType::UInt32):
-		case Fuse(ValueType::Int16, ValueType::UInt64):
-		case Fuse(ValueType::Int32, ValueType::UInt64):
+		if (ValueTypeIsFloat(to))
 		{
-			int64_t intVal = std::stoll(value);
-			if (intVal < 0)
-			{
-				if (dataLostPtr) *dataLostPtr = true;
-				return std::to_string(0); // Clamp to zero for unsigned types
-			}
+			// Note: Converted directly to the type, so floats aren't rounded twice.
+			const uint64_t bits = GetConstantBits(value);
+			if (from == ValueType::UInt64)
+				result.Float = (to == ValueType::Float32 ? static_cast<double>(static_cast<float>(bits)) : static_cast<double>(bits));
+			else
+				result.Float = (to == ValueType::Float32 ? static_cast<double>(static_cast<float>(static_cast<int64_t>(bits))) : static_cast<double>(static_cast<int64_t>(bits)));
 
-			return std::to_string(static_cast<uint64_t>(intVal));
+			return result;
 		}
 
-		// Same size UInt & Int conversions (with boundary checks)
-		case Fuse(ValueType::Int8, ValueType::UInt8):
-		case Fuse(ValueType::Int16, ValueType::UInt16):
-		case Fuse(ValueType::Int32, ValueType::UInt32):
-		case Fuse(ValueType::Int64, ValueType::UInt64):
+		if (ValueTypeIsFloat(from))
 		{
-			int64_t intVal = std::stoll(value);
-			if (intVal < 0)
-			{
-				if (dataLostPtr) *dataLostPtr = true;
-				return std::to_string(0); // Clamp to 0 for unsigned conversion
-			}
+			// Note: Values are truncated through 64 bits, like the generated code.
+			if (std::isnan(value.Float) || value.Float >= 9223372036854775808.0 || value.Float < -9223372036854775808.0)
+				return {};
 
-			return std::to_string(static_cast<uint64_t>(intVal));
+			return GetConstantFromBits(to, static_cast<uint64_t>(static_cast<int64_t>(value.Float)));
 		}
 
-		case Fuse(ValueType::UInt8, ValueType::Int8):
-		case Fuse(ValueType::UInt16, ValueType::Int16):
-		case Fuse(ValueType::UInt32, ValueType::Int32):
-		case Fuse(ValueType::UInt64, ValueType::Int64):
+		return GetConstantFromBits(to, GetConstantBits(value));
+	}
+
+	uint64_t GetConstantBits(const ConstantValue& value)
+	{
+		switch (value.Type)
 		{
-			uint64_t uintVal = std::stoull(value);
-			if (uintVal > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
-			{
-				if (dataLostPtr) *dataLostPtr = true;
-				return std::to_string(std::numeric_limits<int64_t>::max()); // Clamp to max int value
-			}
+		case ValueType::Bool:		return (value.Bool ? 1 : 0);
+
+		case ValueType::Int8:
+		case ValueType::Int16:
+		case ValueType::Int32:
+		case ValueType::Int64:		return static_cast<uint64_t>(value.Int);
+
+		case ValueType::UInt8:
+		case ValueType::UInt16:
+		case ValueType::UInt32:
+		case ValueType::UInt64:		return value.UInt;
 
-			return std::to_string(static_cast<int64_t>(uintVal));
+		case ValueType::Float32:	return std::bit_cast<uint32_t>(static_cast<float>(value.Float));
+		case ValueType::Float64:	return std::bit_cast<uint64_t>(value.Float);
+
+		case ValueType::Char:		return static_cast<uint64_t>(static_cast<int64_t>(value.Char));
+
+		default:
+			break;
 		}
 
-		// Char conversions
-		case Fuse(ValueType::Char, ValueType::Int8):
-		case Fuse(ValueType::Char, ValueType::Int16):	
-		case Fuse(ValueType::Char, ValueType::Int32):	
-		case Fuse(ValueType::Char, ValueType::Int64):	
-		case Fuse(ValueType::Char, ValueType::UInt8):	
-		case Fuse(ValueType::Char, ValueType::UInt16):	
-		case Fuse(ValueType::Char, ValueType::UInt32):	
-		case Fuse(ValueType::Char, ValueType::UInt64):	
+		return 0;
+	}
+
+	ConstantValue GetConstantFromBits(ValueType type, uint64_t bits)
+	{
+		ConstantValue result = {};
+		result.Type = type;
+
+		switch (type)
 		{
-			char c = value[0];
-			int val = static_cast<int>(c);
-			return std::to_string(val);
-		}
+		case ValueType::Bool:		result.Bool = (bits != 0); break;
+
+		case ValueType::Int8:		result.Int = static_cast<int8_t>(bits); break;
+		case ValueType::Int16:		result.Int = static_cast<int16_t>(bits); break;
+		case ValueType::Int32:		result.Int = static_cast<int32_t>(bits); break;
+		case ValueType::Int64:		result.Int = static_cast<int64_t>(bits); break;
+
+		case ValueType::UInt8:		result.UInt = static_cast<uint8_t>(bits); break;
+		case ValueType::UInt16:		result.UInt = static_cast<uint16_t>(bits); break;
+		case ValueType::UInt32:		result.UInt = static_cast<uint32_t>(bits); break;
+		case ValueType::UInt64:		result.UInt = bits; break;
+
+		case ValueType::Float32:	result.Float = static_cast<double>(std::bit_cast<float>(static_cast<uint32_t>(bits))); break;
+		case ValueType::Float64:	result.Float = std::bit_cast<double>(bits); break;
+
+		case ValueType::Char:		result.Char = static_cast<char>(bits); break;
 
 		default:
 			break;
 		}
 
-		DY_LOG_ERROR("Undefined cast from: {0} to {1}", Pulse::Enum::Name(from), Pulse::Enum::Name(to));
-		return {};
+		return result;
 	}
 
-	ValueType GetValueType(TokenType literalType, const std::string& value)
+	ConstantValue GetConstantValue(TokenType literalType, std::string_view value, bool* dataLostPtr)
 	{
-		ValueType type = ValueType::None;
+		ConstantValue constant = {};
 
 		switch (literalType)
 		{
 		case TokenType::BoolLiteral:
 		{
-			type = ValueType::Bool;
+			constant.Type = ValueType::Bool;
+			constant.Bool = (value == "true");
 			break;
 		}
 		case TokenType::IntegerLiteral:
 		{
-			bool isNegative = !value.empty() && value[0] == '-';
+			const bool isNegative = !value.empty() && value[0] == '-';
 
 			if (isNegative)
 			{
-				int64_t intVal = std::stoll(value);
-
-				if (intVal >= Pulse::Numeric::Min<int8_t>() && intVal <= Pulse::Numeric::Max<int8_t>())
-					type = ValueType::Int8;
-				else if (intVal >= Pulse::Numeric::Min<int16_t>() && intVal <= Pulse::Numeric::Max<int16_t>())
-					type = ValueType::Int16;
-				else if (intVal >= Pulse::Numeric::Min<int32_t>() && intVal <= Pulse::Numeric::Max<int32_t>())
-					type = ValueType::Int32;
-				else if (intVal >= Pulse::Numeric::Min<int64_t>() && intVal <= Pulse::Numeric::Max<int64_t>())
-					type = ValueType::Int64;
-				else
-					DY_LOG_ERROR("Integer {0} exceeds max integers' type (Int64) size.", value);
+				int64_t intVal = 0;
+				ParseNumber(value, intVal, dataLostPtr);
+
+				constant.Type = ValueType::Int64;
+				constant.Int = intVal;
 			}
 			else
 			{
-				uint64_t uintVal = std::stoull(value);
-
-				if (uintVal <= Pulse::Numeric::Max<uint8_t>())
-					type = ValueType::UInt8;
-				else if (uintVal <= Pulse::Numeric::Max<uint16_t>())
-					type = ValueType::UInt16;
-				else if (uintVal <= Pulse::Numeric::Max<uint32_t>())
-					type = ValueType::UInt32;
-				else if (uintVal <= Pulse::Numeric::Max<uint64_t>())
-					type = ValueType::UInt64;
-				else
-					DY_LOG_ERROR("Integer {0} exceeds max integers' type (UInt64) size.", value);
+				uint64_t uintVal = 0;
+				ParseNumber(value, uintVal, dataLostPtr);
+
+				constant.Type = ValueType::UInt64;
+				constant.UInt = uintVal;
 			}
+
+			constant.Type = ValueTypeSmallest({ &constant, 1 });
 			break;
 		}
 		case TokenType::FloatLiteral:
 		{
-			double doubleVal = std::stod(value);
-
-			if (doubleVal >= Pulse::Numeric::Min<float>() && doubleVal <= Pulse::Numeric::Max<float>())
-				type = ValueType::Float32;
-			if (doubleVal >= Pulse::Numeric::Min<double>() && doubleVal <= Pulse::Numeric::Max<double>())
-				type = ValueType::Float32;
-			else
-				DY_LOG_ERROR("Float {0} exceeds max floats' type (Float64) size.", value);
+			double doubleVal = 0.0;
+			ParseNumber(value, doubleVal, dataLostPtr);
 
+			// Note: The exact value is kept, it's only rounded once the literal is used as a float.
+			constant.Type = (std::abs(doubleVal) <= Pulse::Numeric::Max<float>() ? ValueType::Float32 : ValueType::Float64);
+			constant.Float = doubleVal;
 			break;
 		}
 		case TokenType::CharLiteral:
 		{
-			type = ValueType::Char;
+			constant.Type = ValueType::Char;
+			constant.Char = (value.empty() ? '\0' : value[0]);
 			break;
 		}
 		case TokenType::StringLiteral:
 		{
-			type = ValueType::String;
+			constant.Type = ValueType::String;
+			constant.String = value;
+			break;
+		}
+
+		default:
 			break;
 		}
 
+		return constant;
+	}
+
+	std::string FormatConstantValue(const ConstantValue& value)
+	{
+		switch (value.Type)
+		{
+		case ValueType::Bool:		return (value.Bool ? "true" : "false");
+
+		case ValueType::Int8:
+		case ValueType::Int16:
+		case ValueType::Int32:
+		case ValueType::Int64:		return std::to_string(value.Int);
+
+		case ValueType::UInt8:
+		case ValueType::UInt16:
+		case ValueType::UInt32:
+		case ValueType::UInt64:		return std::to_string(value.UInt);
+
+		case ValueType::Float32:	return Pulse::Text::Format("{0}", static_cast<float>(value.Float));
+		case ValueType::Float64:	return Pulse::Text::Format("{0}", value.Float);
+
+		case ValueType::Char:		return std::string(1, value.Char);
+		case ValueType::String:		return std::string(value.String);
+
 		default:
 			break;
 		}
 
-		return type;
+		return "UNDEFINED ConstantValue";
 	}
 
 }
\ No newline at end of file
@@ -1,40 +1,25 @@
 #pragma once
 
+#include "Dynamite/Core/Interner.hpp"
+
 #include "Dynamite/Tokens/Token.hpp"
+#include "Dynamite/Tokens/Constant.hpp"
+
+#include <span>
+#include <string>
+#include <optional>
+#include <string_view>
 
 namespace Dynamite
 {
 
 	/////////////////////////////////////////////////////////////////
-	// Types
+	// Variables
 	/////////////////////////////////////////////////////////////////
-	enum class ValueType : uint8_t
-	{
-		None = 0,
-
-		Bool = (uint8_t)TokenType::Bool,
-
-		Int8 = (uint8_t)TokenType::Int8,
-		Int16 = (uint8_t)TokenType::Int16,
-		Int32 = (uint8_t)TokenType::Int32,
-		Int64 = (uint8_t)TokenType::Int64,
-
-		UInt8 = (uint8_t)TokenType::UInt8,
-		UInt16 = (uint8_t)TokenType::UInt16,
-		UInt32 = (uint8_t)TokenType::UInt32,
-		UInt64 = (uint8_t)TokenType::UInt64,
-
-		Float32 = (uint8_t)TokenType::Float32,
-		Float64 = (uint8_t)TokenType::Float64,
-
-		Char = (uint8_t)TokenType::Char,
-		String = (uint8_t)TokenType::String,
-	};
-
 	struct Variable
 	{
 	public:
-		std::string Name = {};
+		SymbolId Symbol = InvalidSymbol;
 		ValueType Type = ValueType::None;
 	};
 
@@ -71,9 +56,34 @@ namespace Dynamite
 	std::string ValueTypeToASM(ValueType type);
 	std::string ValueTypeToStr(ValueType type);
 	size_t ValueTypeSize(ValueType type);
+	// Note: Bool & Char aren't integers.
+	bool ValueTypeIsInteger(ValueType type);
+	bool ValueTypeIsUnsigned(ValueType type);
+	// Note: Char is signed, like in C.
+	bool ValueTypeIsSigned(ValueType type);
+	bool ValueTypeIsFloat(ValueType type);
 	bool ValueTypeCastable(ValueType from, ValueType to);
-	std::string ValueTypeCast(ValueType from, ValueType to, const std::string& value, bool* dataLostPtr = nullptr);
-
-	ValueType GetValueType(TokenType literalType, const std::string& value);
+	// Returns the type of an arithmetic operation on lhs & rhs, the wider of both. Floats win over integers
+	// and signed wins between integers of the same size. Note: Non numeric types keep the type of lhs.
+	ValueType ValueTypePromote(ValueType lhs, ValueType rhs);
+	// Returns true if value is the same number in type, without wrapping around or rounding.
+	bool ValueTypeFits(ValueType type, const ConstantValue& value);
+	// Returns the smallest integer type every value fits in, unsigned unless a value is negative (like integer
+	// literals). Note: Returns ValueType::None if no type fits or a value isn't an integer.
+	ValueType ValueTypeSmallest(std::span<const ConstantValue> values);
+	// Converts value like the generated code does, so integers wrap around instead of being clamped, floats
+	// are truncated and Float32 values are rounded to a float. Note: Returns nothing if the result is undefined, NaN or out of range floats to integers.
+	std::optional<ConstantValue> ValueTypeConvert(ValueType to, const ConstantValue& value);
+
+	// Returns the bits of a constant as stored in 64 bits. Integers are sign or zero extended,
+	// bools are 0 or 1 and floats are their IEEE bits. Note: Strings have no bits.
+	uint64_t GetConstantBits(const ConstantValue& value);
+	// Note: Integers wrap around to the size of type, every value but 0 is true.
+	ConstantValue GetConstantFromBits(ValueType type, uint64_t bits);
+
+	// Decodes the source text of a literal, the type is the smallest type the value fits in.
+	// Note: Values that don't fit in any type are clamped to the largest type, which sets dataLostPtr.
+	ConstantValue GetConstantValue(TokenType literalType, std::string_view value, bool* dataLostPtr = nullptr);
+	std::string FormatConstantValue(const ConstantValue& value);
 
 }
@@ -0,0 +1,294 @@
+#pragma once
+
+#include "Dynamite/Parsing/Nodes.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <type_traits>
+
+namespace Dynamite::Node
+{
+
+	enum class VisitResult : uint8_t
+	{
+		Continue = 0,
+		SkipChildren,	// The children aren't visited, the post hook is still called
+		Stop			// Ends the walk
+	};
+
+	/////////////////////////////////////////////////////////////////
+	// Visitor
+	/////////////////////////////////////////////////////////////////
+	// Note: Walks a Program depth first, calling the pre hook of a node before its
+	// children and the post hook after them. The hooks are resolved at compile time
+	// through Derived (CRTP), so they are direct calls. Derived only declares the hooks
+	// it needs (publicly), the others default to VisitResult::Continue:
+	//
+	//     VisitResult PreExpression(Reference<Expression>)    & PostExpression
+	//     VisitResult PreStatement(Reference<Statement>)      & PostStatement
+	//     VisitResult PreScope(Reference<ScopeStatement>)     & PostScope
+	//     VisitResult PreBranch(Reference<ConditionBranch>)   & PostBranch
+	//
+	// The walk uses an explicit stack (so deep trees can't overflow the stack) and hooks
+	// may start a nested Walk(). Through a Rewriter hooks can replace the node they are
+	// given with Program::Replace(), the children of the replacement are walked.
+	// A Rewriter expands the lazy scopes it walks into, a Visitor skips their statements.
+	template<typename Derived, typename TProgram = const Program>
+	class Visitor
+	{
+	public:
+		Visitor(TProgram& program)
+			: m_Program(program) {}
+		~Visitor() = default;
+
+		// Walks all top level statements, returns false if the walk was stopped.
+		bool Walk();
+		bool Walk(Reference<Expression> expr);
+		bool Walk(Reference<Statement> statement);
+		bool Walk(Reference<ScopeStatement> scope);
+		bool Walk(Reference<ConditionBranch> branch);
+
+		inline TProgram& GetProgram() const { return m_Program; }
+
+	public:
+		// Default hooks
+		inline VisitResult PreExpression(Reference<Expression>) { return VisitResult::Continue; }
+		inline VisitResult PostExpression(Reference<Expression>) { return VisitResult::Continue; }
+		inline VisitResult PreStatement(Reference<Statement>) { return VisitResult::Continue; }
+		inline VisitResult PostStatement(Reference<Statement>) { return VisitResult::Continue; }
+		inline VisitResult PreScope(Reference<ScopeStatement>) { return VisitResult::Continue; }
+		inline VisitResult PostScope(Reference<ScopeStatement>) { return VisitResult::Continue; }
+		inline VisitResult PreBranch(Reference<ConditionBranch>) { return VisitResult::Continue; }
+		inline VisitResult PostBranch(Reference<ConditionBranch>) { return VisitResult::Continue; }
+
+	private:
+		struct Work
+		{
+		public:
+			enum class Kind : uint8_t { Expression, Statement, Scope, Branch };
+		public:
+			Kind WorkKind = Kind::Expression;
+			bool Post = false;
+			uint32_t Index = 0; // Of the node
+		};
+
+		// Processes the work on the stack above base.
+		bool Run(size_t base);
+
+		VisitResult Call(const Work& work);
+		void PushChildren(const Work& work);
+
+		inline Derived& GetDerived() { return static_cast<Derived&>(*this); }
+
+	private:
+		TProgram& m_Program;
+		std::vector<Work> m_Stack = { };
+	};
+
+	// Note: A Visitor with a mutable Program, for passes that modify the tree.
+	template<typename Derived>
+	class Rewriter : public Visitor<Derived, Program>
+	{
+	public:
+		Rewriter(Program& program)
+			: Visitor<Derived, Program>(program) {}
+		~Rewriter() = default;
+	};
+
+	/////////////////////////////////////////////////////////////////
+	// Templated functions
+	/////////////////////////////////////////////////////////////////
+	template<typename Derived, typename TProgram>
+	bool Visitor<Derived, TProgram>::Walk()
+	{
+		const size_t base = m_Stack.size();
+
+		const StatementRange statements = m_Program.GetStatements();
+		for (size_t i = statements.Size(); i > 0; i--)
+			m_Stack.push_back({ Work::Kind::Statement, false, statements[i - 1].Index });
+
+		return Run(base);
+	}
+
+	template<typename Derived, typename TProgram>
+	bool Visitor<Derived, TProgram>::Walk(Reference<Expression> expr)
+	{
+		const size_t base = m_Stack.size();
+		m_Stack.push_back({ Work::Kind::Expression, false, expr.Index });
+		return Run(base);
+	}
+
+	template<typename Derived, typename TProgram>
+	bool Visitor<Derived, TProgram>::Walk(Reference<Statement> statement)
+	{
+		const size_t base = m_Stack.size();
+		m_Stack.push_back({ Work::Kind::Statement, false, statement.Index });
+		return Run(base);
+	}
+
+	template<typename Derived, typename TProgram>
+	bool Visitor<Derived, TProgram>::Walk(Reference<ScopeStatement> scope)
+	{
+		const size_t base = m_Stack.size();
+		m_Stack.push_back({ Work::Kind::Scope, false, scope.Index });
+		return Run(base);
+	}
+
+	template<typename Derived, typename TProgram>
+	bool Visitor<Derived, TProgram>::Walk(Reference<ConditionBranch> branch)
+	{
+		const size_t base = m_Stack.size();
+		m_Stack.push_back({ Work::Kind::Branch, false, branch.Index });
+		return Run(base);
+	}
+
+	template<typename Derived, typename TProgram>
+	bool Visitor<Derived, TProgram>::Run(size_t base)
+	{
+		while (m_Stack.size() > base)
+		{
+			const Work work = m_Stack.back();
+			m_Stack.pop_back();
+
+			const VisitResult result = Call(work);
+			if (result == VisitResult::Stop)
+			{
+				m_Stack.resize(base);
+				return false;
+			}
+
+			if (work.Post)
+				continue;
+
+			// Note: The post hook comes after the children, so it's pushed first.
+			m_Stack.push_back({ work.WorkKind, true, work.Index });
+			if (result != VisitResult::SkipChildren)
+				PushChildren(work);
+		}
+
+		return true;
+	}
+
+	template<typename Derived, typename TProgram>
+	VisitResult Visitor<Derived, TProgram>::Call(const Work& work)
+	{
+		switch (work.WorkKind)
+		{
+		case Work::Kind::Expression:
+			return (work.Post ? GetDerived().PostExpression({ work.Index }) : GetDerived().PreExpression({ work.Index }));
+		case Work::Kind::Statement:
+			return (work.Post ? GetDerived().PostStatement({ work.Index }) : GetDerived().PreStatement({ work.Index }));
+		case Work::Kind::Scope:
+			return (work.Post ? GetDerived().PostScope({ work.Index }) : GetDerived().PreScope({ work.Index }));
+		case Work::Kind::Branch:
+			return (work.Post ? GetDerived().PostBranch({ work.Index }) : GetDerived().PreBranch({ work.Index }));
+
+		default:
+			break;
+		}
+
+		return VisitResult::Continue;
+	}
+
+	// Note: Has to be manually updated
+	template<typename Derived, typename TProgram>
+	void Visitor<Derived, TProgram>::PushChildren(const Work& work)
+	{
+		// Note: Children are pushed in reverse, so they are visited in source order.
+		// Invalid references (from expressions that failed to parse) are skipped.
+		auto push = [this](typename Work::Kind kind, uint32_t index)
+		{
+			if (index != Reference<Expression>::InvalidIndex)
+				m_Stack.push_back({ kind, false, index });
+		};
+
+		switch (work.WorkKind)
+		{
+		case Work::Kind::Expression:
+		{
+			const Reference<Expression> expr = { work.Index };
+			switch (m_Program.GetKind(expr))
+			{
+			case Expression::Kind::Binary:
+			{
+				const BinaryExpr& binary = m_Program.GetBinary(expr);
+				push(Work::Kind::Expression, binary.RHS.Index);
+				push(Work::Kind::Expression, binary.LHS.Index);
+				break;
+			}
+
+			default: // Note: Literals & identifiers have no children
+				break;
+			}
+			break;
+		}
+		case Work::Kind::Statement:
+		{
+			const Reference<Statement> statement = { work.Index };
+			switch (m_Program.GetKind(statement))
+			{
+			case Statement::Kind::Variable:
+				push(Work::Kind::Expression, m_Program.GetVariable(statement).ExprObj.Index);
+				break;
+			case Statement::Kind::Exit:
+				push(Work::Kind::Expression, m_Program.GetExit(statement).Index);
+				break;
+			case Statement::Kind::Scope:
+				push(Work::Kind::Scope, m_Program.GetScope(statement).Index);
+				break;
+			case Statement::Kind::If:
+			{
+				const IfStatement& ifStatement = m_Program.GetIf(statement);
+				push(Work::Kind::Branch, ifStatement.Next.Index);
+				push(Work::Kind::Scope, ifStatement.Scope.Index);
+				push(Work::Kind::Expression, ifStatement.ExprObj.Index);
+				break;
+			}
+			case Statement::Kind::Assignment:
+				push(Work::Kind::Expression, m_Program.GetAssignment(statement).ExprObj.Index);
+				break;
+
+			default:
+				break;
+			}
+			break;
+		}
+		case Work::Kind::Scope:
+		{
+			if constexpr (!std::is_const_v<TProgram>)
+				m_Program.Expand(Reference<ScopeStatement>{ work.Index });
+
+			const StatementRange statements = m_Program.GetStatements(Reference<ScopeStatement>{ work.Index });
+			for (size_t i = statements.Size(); i > 0; i--)
+				push(Work::Kind::Statement, statements[i - 1].Index);
+			break;
+		}
+		case Work::Kind::Branch:
+		{
+			const Reference<ConditionBranch> branch = { work.Index };
+			switch (m_Program.GetKind(branch))
+			{
+			case ConditionBranch::Kind::ElseIf:
+			{
+				const ElseIfBranch& elseIf = m_Program.GetElseIf(branch);
+				push(Work::Kind::Branch, elseIf.Next.Index);
+				push(Work::Kind::Scope, elseIf.Scope.Index);
+				push(Work::Kind::Expression, elseIf.ExprObj.Index);
+				break;
+			}
+			case ConditionBranch::Kind::Else:
+				push(Work::Kind::Scope, m_Program.GetElse(branch).Index);
+				break;
+
+			default:
+				break;
+			}
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Dynamite/Tokens/Token.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// Types
+	/////////////////////////////////////////////////////////////////
+	enum class ValueType : uint8_t
+	{
+		None = 0,
+
+		Bool = (uint8_t)TokenType::Bool,
+
+		Int8 = (uint8_t)TokenType::Int8,
+		Int16 = (uint8_t)TokenType::Int16,
+		Int32 = (uint8_t)TokenType::Int32,
+		Int64 = (uint8_t)TokenType::Int64,
+
+		UInt8 = (uint8_t)TokenType::UInt8,
+		UInt16 = (uint8_t)TokenType::UInt16,
+		UInt32 = (uint8_t)TokenType::UInt32,
+		UInt64 = (uint8_t)TokenType::UInt64,
+
+		Float32 = (uint8_t)TokenType::Float32,
+		Float64 = (uint8_t)TokenType::Float64,
+
+		Char = (uint8_t)TokenType::Char,
+		String = (uint8_t)TokenType::String,
+	};
+
+	/////////////////////////////////////////////////////////////////
+	// Constants
+	/////////////////////////////////////////////////////////////////
+	// Note: A literal value decoded once by the tokenizer, Type is the
+	// tag and bit width, which decides the active member. Float32 literals
+	// keep their exact value as a double, so they don't lose precision when
+	// they become a Float64. They're rounded to a float when they're used as
+	// one, every computed Float32 value is exactly representable as a float.
+	struct ConstantValue
+	{
+	public:
+		ValueType Type = ValueType::None;
+
+		union
+		{
+			bool Bool;
+			int64_t Int;	// Int8 - Int64
+			uint64_t UInt;	// UInt8 - UInt64
+			double Float;	// Float32 & Float64
+			char Char;
+			std::string_view String = {}; // Note: A view into the source.
+		};
+	};
+
+}
\ No newline at end of file
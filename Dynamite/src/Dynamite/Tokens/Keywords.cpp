@@ -0,0 +1,137 @@
+#include "dypch.h"
+#include "Keywords.hpp"
+
+#include <array>
+
+namespace Dynamite
+{
+
+	namespace
+	{
+		// Note: New keywords only need to be added here, the
+		// hash table gets regenerated at compile time.
+		constexpr const Keyword s_Keywords[] = 
+		{
+			// Types
+			{ "bool", TokenType::Bool },
+
+			{ "i8", TokenType::Int8 },
+			{ "i16", TokenType::Int16 },
+			{ "i32", TokenType::Int32 },
+			{ "i64", TokenType::Int64 },
+
+			{ "u8", TokenType::UInt8 },
+			{ "u16", TokenType::UInt16 },
+			{ "u32", TokenType::UInt32 },
+			{ "u64", TokenType::UInt64 },
+
+			{ "f32", TokenType::Float32 },
+			{ "f64", TokenType::Float64 },
+
+			{ "char", TokenType::Char },
+			{ "str", TokenType::String },
+
+			// If / Else
+			{ "if", TokenType::If },
+			{ "else", TokenType::Else },
+
+			// Boolean values
+			{ "false", TokenType::BoolLiteral },
+			{ "true", TokenType::BoolLiteral },
+
+			// Exit function // TODO: Make reusable for all functions
+			{ "exit", TokenType::Exit },
+		};
+
+		constexpr const size_t s_KeywordCount = std::size(s_Keywords);
+
+		/////////////////////////////////////////////////////////////////
+		// Perfect hashing
+		/////////////////////////////////////////////////////////////////
+		constexpr size_t NextPowerOfTwo(size_t value)
+		{
+			size_t result = 1;
+			while (result < value)
+				result <<= 1;
+
+			return result;
+		}
+
+		// Note: At least 2x the keyword count, so a collision free seed is easy to find.
+		constexpr const size_t s_TableSize = NextPowerOfTwo(s_KeywordCount * 2);
+
+		constexpr const size_t s_MaxKeywordLength = []()
+		{
+			size_t length = 0;
+			for (const auto& keyword : s_Keywords)
+				length = (keyword.Name.size() > length ? keyword.Name.size() : length);
+
+			return length;
+		}();
+
+		// FNV-1a with a custom offset basis (the seed)
+		constexpr uint32_t Hash(std::string_view name, uint32_t seed)
+		{
+			uint32_t hash = seed;
+			for (char c : name)
+			{
+				hash ^= static_cast<uint8_t>(c);
+				hash *= 16777619u;
+			}
+
+			return hash;
+		}
+
+		constexpr bool IsPerfectSeed(uint32_t seed)
+		{
+			std::array<bool, s_TableSize> used = { };
+			for (const auto& keyword : s_Keywords)
+			{
+				size_t slot = Hash(keyword.Name, seed) & (s_TableSize - 1);
+				if (used[slot])
+					return false;
+
+				used[slot] = true;
+			}
+
+			return true;
+		}
+
+		constexpr const uint32_t s_Seed = []()
+		{
+			uint32_t seed = 2166136261u;
+			while (!IsPerfectSeed(seed))
+				seed++;
+
+			return seed;
+		}();
+
+		// Note: Stores the index into s_Keywords + 1, 0 means empty.
+		constexpr const std::array<uint8_t, s_TableSize> s_Table = []()
+		{
+			std::array<uint8_t, s_TableSize> table = { };
+			for (size_t i = 0; i < s_KeywordCount; i++)
+				table[Hash(s_Keywords[i].Name, s_Seed) & (s_TableSize - 1)] = static_cast<uint8_t>(i + 1);
+
+			return table;
+		}();
+
+		static_assert(s_KeywordCount < 256, "Keyword indices are stored as uint8_t.");
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// Helper functions
+	/////////////////////////////////////////////////////////////////
+	const Keyword* FindKeyword(std::string_view name)
+	{
+		if (name.size() > s_MaxKeywordLength)
+			return nullptr;
+
+		uint8_t index = s_Table[Hash(name, s_Seed) & (s_TableSize - 1)];
+		if (index == 0 || s_Keywords[index - 1].Name != name)
+			return nullptr;
+
+		return &s_Keywords[index - 1];
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Dynamite/Tokens/Token.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// Keywords
+	/////////////////////////////////////////////////////////////////
+	struct Keyword
+	{
+	public:
+		std::string_view Name = {};
+		TokenType Type = TokenType::None;
+	};
+
+	/////////////////////////////////////////////////////////////////
+	// Helper functions
+	/////////////////////////////////////////////////////////////////
+	// Returns the keyword or type with the name, or nullptr if the name is a normal identifier.
+	const Keyword* FindKeyword(std::string_view name);
+
+}
\ No newline at end of file
@@ -0,0 +1,435 @@
+#include "dypch.h"
+#include "Scanning.hpp"
+
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64)
+	#define DY_SCANNING_X86 1
+	#include <immintrin.h>
+
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+		#define DY_TARGET_SSE42
+		#define DY_TARGET_AVX2
+	#else
+		#define DY_TARGET_SSE42 __attribute__((target("sse4.2")))
+		#define DY_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#else
+	#define DY_SCANNING_X86 0
+#endif
+
+namespace Dynamite::Scanning
+{
+
+	namespace
+	{
+		/////////////////////////////////////////////////////////////////
+		// Scalar
+		/////////////////////////////////////////////////////////////////
+		static bool IsWhitespace(char c)
+		{
+			return (c == ' ' || (c >= '\t' && c <= '\r'));
+		}
+
+		static bool IsIdentifierChar(char c)
+		{
+			return ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_');
+		}
+
+		static size_t SkipWhitespaceScalar(std::string_view content, size_t index, std::vector<uint32_t>& lineStarts)
+		{
+			while (index < content.size() && IsWhitespace(content[index]))
+			{
+				if (content[index] == '\n')
+					lineStarts.push_back(static_cast<uint32_t>(index + 1));
+
+				index++;
+			}
+
+			return index;
+		}
+
+		static size_t SkipIdentifierScalar(std::string_view content, size_t index)
+		{
+			while (index < content.size() && IsIdentifierChar(content[index]))
+				index++;
+
+			return index;
+		}
+
+		static size_t FindLineEndScalar(std::string_view content, size_t index)
+		{
+			while (index < content.size() && content[index] != '\n')
+				index++;
+
+			return index;
+		}
+
+		static size_t FindBlockCommentEndScalar(std::string_view content, size_t index, std::vector<uint32_t>& lineStarts)
+		{
+			while (index < content.size())
+			{
+				if (content[index] == '*' && index + 1 < content.size() && content[index + 1] == '/')
+					return index;
+				else if (content[index] == '\n')
+					lineStarts.push_back(static_cast<uint32_t>(index + 1));
+
+				index++;
+			}
+
+			return index;
+		}
+
+		static size_t FindStringEndScalar(std::string_view content, size_t index)
+		{
+			while (index < content.size() && !(content[index] == '"' && content[index - 1] != '\\'))
+				index++;
+
+			return index;
+		}
+
+		// Note: Used by the vectorized versions to record the newlines (in mask) in front of end.
+		static void PushLineStarts(std::vector<uint32_t>& lineStarts, size_t index, uint32_t mask, uint32_t end)
+		{
+			if (end < 32)
+				mask &= ((1u << end) - 1u);
+
+			while (mask)
+			{
+				lineStarts.push_back(static_cast<uint32_t>(index + std::countr_zero(mask) + 1));
+				mask &= (mask - 1u);
+			}
+		}
+
+		#if DY_SCANNING_X86
+		/////////////////////////////////////////////////////////////////
+		// SSE4.2 (16 bytes at a time)
+		/////////////////////////////////////////////////////////////////
+		DY_TARGET_SSE42 static uint32_t NewlineMask16(__m128i chunk)
+		{
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))));
+		}
+
+		DY_TARGET_SSE42 static size_t SkipWhitespaceSSE42(std::string_view content, size_t index, std::vector<uint32_t>& lineStarts)
+		{
+			const __m128i ranges = _mm_setr_epi8('\t', '\r', ' ', ' ', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+			while (index + 16 <= content.size())
+			{
+				__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(content.data() + index));
+				uint32_t end = static_cast<uint32_t>(_mm_cmpestri(ranges, 4, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT));
+
+				PushLineStarts(lineStarts, index, NewlineMask16(chunk), end);
+				if (end != 16)
+					return index + end;
+
+				index += 16;
+			}
+
+			return SkipWhitespaceScalar(content, index, lineStarts);
+		}
+
+		DY_TARGET_SSE42 static size_t SkipIdentifierSSE42(std::string_view content, size_t index)
+		{
+			const __m128i ranges = _mm_setr_epi8('a', 'z', 'A', 'Z', '0', '9', '_', '_', 0, 0, 0, 0, 0, 0, 0, 0);
+
+			while (index + 16 <= content.size())
+			{
+				__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(content.data() + index));
+				int end = _mm_cmpestri(ranges, 8, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT);
+
+				if (end != 16)
+					return index + end;
+
+				index += 16;
+			}
+
+			return SkipIdentifierScalar(content, index);
+		}
+
+		DY_TARGET_SSE42 static size_t FindLineEndSSE42(std::string_view content, size_t index)
+		{
+			const __m128i set = _mm_setr_epi8('\n', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+			while (index + 16 <= content.size())
+			{
+				__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(content.data() + index));
+				int end = _mm_cmpestri(set, 1, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+
+				if (end != 16)
+					return index + end;
+
+				index += 16;
+			}
+
+			return FindLineEndScalar(content, index);
+		}
+
+		DY_TARGET_SSE42 static size_t FindBlockCommentEndSSE42(std::string_view content, size_t index, std::vector<uint32_t>& lineStarts)
+		{
+			// Note: We also load the next byte, so we need 17 bytes.
+			while (index + 17 <= content.size())
+			{
+				__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(content.data() + index));
+				__m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(content.data() + index + 1));
+
+				uint32_t match = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('*')), _mm_cmpeq_epi8(next, _mm_set1_epi8('/')))));
+				uint32_t end = (match ? std::countr_zero(match) : 16);
+
+				PushLineStarts(lineStarts, index, NewlineMask16(chunk), end);
+				if (match)
+					return index + end;
+
+				index += 16;
+			}
+
+			return FindBlockCommentEndScalar(content, index, lineStarts);
+		}
+
+		DY_TARGET_SSE42 static size_t FindStringEndSSE42(std::string_view content, size_t index)
+		{
+			while (index + 16 <= content.size())
+			{
+				__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(content.data() + index));
+				__m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(content.data() + index - 1));
+
+				uint32_t match = static_cast<uint32_t>(_mm_movemask_epi8(_mm_andnot_si128(_mm_cmpeq_epi8(previous, _mm_set1_epi8('\\')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')))));
+				if (match)
+					return index + std::countr_zero(match);
+
+				index += 16;
+			}
+
+			return FindStringEndScalar(content, index);
+		}
+
+		/////////////////////////////////////////////////////////////////
+		// AVX2 (32 bytes at a time)
+		/////////////////////////////////////////////////////////////////
+		DY_TARGET_AVX2 static __m256i InRange32(__m256i chunk, char low, char high)
+		{
+			// Note: (c - low) <= (high - low) as unsigned, is the same as low <= c <= high
+			__m256i offset = _mm256_sub_epi8(chunk, _mm256_set1_epi8(low));
+			return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(static_cast<char>(high - low))), offset);
+		}
+
+		DY_TARGET_AVX2 static uint32_t NewlineMask32(__m256i chunk)
+		{
+			return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))));
+		}
+
+		DY_TARGET_AVX2 static size_t SkipWhitespaceAVX2(std::string_view content, size_t index, std::vector<uint32_t>& lineStarts)
+		{
+			while (index + 32 <= content.size())
+			{
+				__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(content.data() + index));
+				__m256i whitespace = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')), InRange32(chunk, '\t', '\r'));
+
+				uint32_t other = ~static_cast<uint32_t>(_mm256_movemask_epi8(whitespace));
+				uint32_t end = (other ? std::countr_zero(other) : 32);
+
+				PushLineStarts(lineStarts, index, NewlineMask32(chunk), end);
+				if (other)
+					return index + end;
+
+				index += 32;
+			}
+
+			return SkipWhitespaceSSE42(content, index, lineStarts);
+		}
+
+		DY_TARGET_AVX2 static size_t SkipIdentifierAVX2(std::string_view content, size_t index)
+		{
+			while (index + 32 <= content.size())
+			{
+				__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(content.data() + index));
+				__m256i lower = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+
+				__m256i identifier = _mm256_or_si256(InRange32(lower, 'a', 'z'), InRange32(chunk, '0', '9'));
+				identifier = _mm256_or_si256(identifier, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('_')));
+
+				uint32_t other = ~static_cast<uint32_t>(_mm256_movemask_epi8(identifier));
+				if (other)
+					return index + std::countr_zero(other);
+
+				index += 32;
+			}
+
+			return SkipIdentifierSSE42(content, index);
+		}
+
+		DY_TARGET_AVX2 static size_t FindLineEndAVX2(std::string_view content, size_t index)
+		{
+			while (index + 32 <= content.size())
+			{
+				__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(content.data() + index));
+
+				uint32_t match = NewlineMask32(chunk);
+				if (match)
+					return index + std::countr_zero(match);
+
+				index += 32;
+			}
+
+			return FindLineEndSSE42(content, index);
+		}
+
+		DY_TARGET_AVX2 static size_t FindBlockCommentEndAVX2(std::string_view content, size_t index, std::vector<uint32_t>& lineStarts)
+		{
+			// Note: We also load the next byte, so we need 33 bytes.
+			while (index + 33 <= content.size())
+			{
+				__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(content.data() + index));
+				__m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(content.data() + index + 1));
+
+				uint32_t match = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('*')), _mm256_cmpeq_epi8(next, _mm256_set1_epi8('/')))));
+				uint32_t end = (match ? std::countr_zero(match) : 32);
+
+				PushLineStarts(lineStarts, index, NewlineMask32(chunk), end);
+				if (match)
+					return index + end;
+
+				index += 32;
+			}
+
+			return FindBlockCommentEndSSE42(content, index, lineStarts);
+		}
+
+		DY_TARGET_AVX2 static size_t FindStringEndAVX2(std::string_view content, size_t index)
+		{
+			while (index + 32 <= content.size())
+			{
+				__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(content.data() + index));
+				__m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(content.data() + index - 1));
+
+				uint32_t match = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_andnot_si256(_mm256_cmpeq_epi8(previous, _mm256_set1_epi8('\\')), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')))));
+				if (match)
+					return index + std::countr_zero(match);
+
+				index += 32;
+			}
+
+			return FindStringEndSSE42(content, index);
+		}
+		#endif
+
+		/////////////////////////////////////////////////////////////////
+		// Dispatching
+		/////////////////////////////////////////////////////////////////
+		static ISA DetectISA()
+		{
+			#if DY_SCANNING_X86
+				#if defined(_MSC_VER) && !defined(__clang__)
+					int info[4] = {};
+					__cpuid(info, 0);
+					const int maxLeaf = info[0];
+
+					__cpuid(info, 1);
+					const bool sse42 = (info[2] & (1 << 20)) != 0;
+					const bool osxsave = (info[2] & (1 << 27)) != 0;
+
+					bool avx2 = false;
+					if (maxLeaf >= 7 && osxsave && ((_xgetbv(0) & 0x6) == 0x6))
+					{
+						__cpuidex(info, 7, 0);
+						avx2 = (info[1] & (1 << 5)) != 0;
+					}
+				#else
+					__builtin_cpu_init();
+					const bool sse42 = __builtin_cpu_supports("sse4.2");
+					const bool avx2 = __builtin_cpu_supports("avx2");
+				#endif
+
+				if (avx2 && sse42) return ISA::AVX2;
+				if (sse42) return ISA::SSE42;
+			#endif
+
+			return ISA::Scalar;
+		}
+
+		struct ScanningFunctions
+		{
+		public:
+			size_t (*SkipWhitespace)(std::string_view, size_t, std::vector<uint32_t>&) = &SkipWhitespaceScalar;
+			size_t (*SkipIdentifier)(std::string_view, size_t) = &SkipIdentifierScalar;
+			size_t (*FindLineEnd)(std::string_view, size_t) = &FindLineEndScalar;
+			size_t (*FindBlockCommentEnd)(std::string_view, size_t, std::vector<uint32_t>&) = &FindBlockCommentEndScalar;
+			size_t (*FindStringEnd)(std::string_view, size_t) = &FindStringEndScalar;
+		};
+
+		static ScanningFunctions CreateScanningFunctions(ISA isa)
+		{
+			ScanningFunctions functions = {};
+
+			#if DY_SCANNING_X86
+			switch (isa)
+			{
+			case ISA::AVX2:
+				functions.SkipWhitespace = &SkipWhitespaceAVX2;
+				functions.SkipIdentifier = &SkipIdentifierAVX2;
+				functions.FindLineEnd = &FindLineEndAVX2;
+				functions.FindBlockCommentEnd = &FindBlockCommentEndAVX2;
+				functions.FindStringEnd = &FindStringEndAVX2;
+				break;
+			case ISA::SSE42:
+				functions.SkipWhitespace = &SkipWhitespaceSSE42;
+				functions.SkipIdentifier = &SkipIdentifierSSE42;
+				functions.FindLineEnd = &FindLineEndSSE42;
+				functions.FindBlockCommentEnd = &FindBlockCommentEndSSE42;
+				functions.FindStringEnd = &FindStringEndSSE42;
+				break;
+
+			default:
+				break;
+			}
+			#endif
+
+			return functions;
+		}
+
+		static const ScanningFunctions& GetFunctions()
+		{
+			static const ScanningFunctions s_Functions = CreateScanningFunctions(GetISA());
+			return s_Functions;
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// Instruction sets
+	/////////////////////////////////////////////////////////////////
+	ISA GetISA()
+	{
+		static const ISA s_ISA = DetectISA();
+		return s_ISA;
+	}
+
+	/////////////////////////////////////////////////////////////////
+	// Scanning functions
+	/////////////////////////////////////////////////////////////////
+	size_t SkipWhitespace(std::string_view content, size_t index, std::vector<uint32_t>& lineStarts)
+	{
+		return GetFunctions().SkipWhitespace(content, index, lineStarts);
+	}
+
+	size_t SkipIdentifier(std::string_view content, size_t index)
+	{
+		return GetFunctions().SkipIdentifier(content, index);
+	}
+
+	size_t FindLineEnd(std::string_view content, size_t index)
+	{
+		return GetFunctions().FindLineEnd(content, index);
+	}
+
+	size_t FindBlockCommentEnd(std::string_view content, size_t index, std::vector<uint32_t>& lineStarts)
+	{
+		return GetFunctions().FindBlockCommentEnd(content, index, lineStarts);
+	}
+
+	size_t FindStringEnd(std::string_view content, size_t index)
+	{
+		return GetFunctions().FindStringEnd(content, index);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Dynamite::Scanning
+{
+
+	/////////////////////////////////////////////////////////////////
+	// Instruction sets
+	/////////////////////////////////////////////////////////////////
+	enum class ISA : uint8_t
+	{
+		Scalar = 0,
+		SSE42,
+		AVX2,
+	};
+
+	// Returns the widest instruction set supported by the current CPU,
+	// this is detected once and used by all the scanning functions below.
+	ISA GetISA();
+
+	/////////////////////////////////////////////////////////////////
+	// Scanning functions
+	// Note: All functions take the index to start scanning at and
+	// return the index of the first character that doesn't belong
+	// to the run, or content.size() if the end has been reached.
+	// Every '\n' that gets passed pushes the index after it (the
+	// start of the next line) to lineStarts.
+	/////////////////////////////////////////////////////////////////
+	// Skips ' ', '\t', '\n', '\v', '\f' & '\r'
+	size_t SkipWhitespace(std::string_view content, size_t index, std::vector<uint32_t>& lineStarts);
+
+	// Skips [a-zA-Z0-9_]
+	size_t SkipIdentifier(std::string_view content, size_t index);
+
+	// Returns the index of the first '\n'.
+	size_t FindLineEnd(std::string_view content, size_t index);
+
+	// Returns the index of the '*' of the first "*/".
+	size_t FindBlockCommentEnd(std::string_view content, size_t index, std::vector<uint32_t>& lineStarts);
+
+	// Returns the index of the first '"' that isn't preceded by a '\'.
+	// Note: index must be > 0, since the preceding character gets checked.
+	size_t FindStringEnd(std::string_view content, size_t index);
+
+}
\ No newline at end of file
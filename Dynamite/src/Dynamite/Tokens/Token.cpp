@@ -15,27 +15,37 @@ namespace Dynamite
 	// Tokens
 	/////////////////////////////////////////////////////////////////
 	Token::Token()
-		: Type(TokenType::None), Value({}), LineNumber(0)
+		: Type(TokenType::None), Value(), Location(), Symbol(InvalidSymbol)
 	{
 	}
 
-	Token::Token(TokenType type, uint32_t line)
-		: Type(type), Value({}), LineNumber(line)
+	Token::Token(TokenType type, SourceLocation location)
+		: Type(type), Value(), Location(location), Symbol(InvalidSymbol)
 	{
 	}
 
-	Token::Token(TokenType type, std::optional<std::string> value, uint32_t line)
-		: Type(type), Value(value), LineNumber(line)
+	Token::Token(TokenType type, std::string_view value, SourceLocation location, SymbolId symbol)
+		: Type(type), Value(value), Location(location), Symbol(symbol)
 	{
 	}
 
 	/////////////////////////////////////////////////////////////////
 	// Helper functions
 	/////////////////////////////////////////////////////////////////
+	bool TokenHasValue(TokenType type)
+	{
+		return (type >= TokenType::Identifier && type <= TokenType::StringLiteral);
+	}
+
+	bool TokenIsLiteral(TokenType type)
+	{
+		return (type >= TokenType::BoolLiteral && type <= TokenType::StringLiteral);
+	}
+
 	std::string FormatToken(const Token& token)
 	{
-		if (token.Value.has_value())
-			return Pulse::Text::Format("TokenType::{0}, Value = {1}", Pulse::Enum::Name(token.Type), token.Value.value());
+		if (TokenHasValue(token.Type))
+			return Pulse::Text::Format("TokenType::{0}, Value = {1}", Pulse::Enum::Name(token.Type), token.Value);
 		else
 			return Pulse::Text::Format("TokenType::{0}", Pulse::Enum::Name(token.Type));
 	}
@@ -1,9 +1,13 @@
 #pragma once
 
+#include "Dynamite/Core/Interner.hpp"
+#include "Dynamite/Core/SourceLocation.hpp"
+
 #include <cstdint>
+#include <initializer_list>
 
 #include <string>
-#include <optional>
+#include <string_view>
 
 namespace Dynamite
 {
@@ -38,6 +42,11 @@ namespace Dynamite
 		And = '&',					// (Current lowest 38) Note: Keep in mind
 		Xor = '^',
 
+		LessThan = '<',				// '<'
+		Less = LessThan,
+		GreaterThan = '>',			// '>'
+		Greater = GreaterThan,
+
 		// Main
 		Identifier = 1,				// Variable/function name
 
@@ -71,26 +80,71 @@ namespace Dynamite
 
 		Char,
 		String,
+
+		// Two char operators // Note: Have to stay below the lowest char token
+		EqualsEquals,				// '=='
+		Equal = EqualsEquals,
+		ExclamationEquals,			// '!='
+		NotEqual = ExclamationEquals,
+		LessThanEquals,				// '<='
+		LessEqual = LessThanEquals,
+		GreaterThanEquals,			// '>='
+		GreaterEqual = GreaterThanEquals,
+
+		AndAnd,						// '&&'
+		LogicalAnd = AndAnd,
+		PipePipe,					// '||'
+		LogicalOr = PipePipe,
 	};
 
+	static_assert(static_cast<uint8_t>(TokenType::PipePipe) < static_cast<uint8_t>(TokenType::And), "Two char operators collide with char tokens.");
+
+	// Note: Value is a view into the source (or other stable storage), it is never owned by the token.
 	struct Token
 	{
 	public:
 		TokenType Type;
-		std::optional<std::string> Value;
+		std::string_view Value;
 
-		uint32_t LineNumber;
+		SourceLocation Location;
+
+		// Note: Only set for identifiers
+		SymbolId Symbol;
 
 	public:
 		Token();
-		Token(TokenType type, uint32_t line = 0);
-		Token(TokenType type, std::optional<std::string> value, uint32_t line = 0);
+		Token(TokenType type, SourceLocation location = {});
+		Token(TokenType type, std::string_view value, SourceLocation location = {}, SymbolId symbol = InvalidSymbol);
 		~Token() = default;
 	};
 
+	/////////////////////////////////////////////////////////////////
+	// Token classes
+	/////////////////////////////////////////////////////////////////
+	// Note: A bitset of TokenTypes which can be built at compile time,
+	// so checking whether a token belongs to a class never allocates.
+	class TokenTypeSet
+	{
+	public:
+		constexpr TokenTypeSet(std::initializer_list<TokenType> types)
+		{
+			for (const TokenType type : types)
+				m_Bits[static_cast<uint8_t>(type) >> 6] |= (uint64_t(1) << (static_cast<uint8_t>(type) & 63));
+		}
+
+		constexpr bool Contains(TokenType type) const { return (m_Bits[static_cast<uint8_t>(type) >> 6] >> (static_cast<uint8_t>(type) & 63)) & 1; }
+
+	private:
+		uint64_t m_Bits[4] = { };
+	};
+
 	/////////////////////////////////////////////////////////////////
 	// Helper functions
 	/////////////////////////////////////////////////////////////////
+	// Returns true for identifiers & literals, the only tokens whose value is used.
+	bool TokenHasValue(TokenType type);
+	bool TokenIsLiteral(TokenType type);
+
 	std::string FormatToken(const Token& token);
 
 }
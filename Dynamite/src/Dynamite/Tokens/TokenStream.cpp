@@ -0,0 +1,89 @@
+#include "dypch.h"
+#include "TokenStream.hpp"
+
+namespace Dynamite
+{
+
+	void TokenStream::Clear(std::string_view source, const Interner* symbols, SourceLocation base)
+	{
+		m_Source = source;
+		m_Symbols = symbols;
+		m_Base = base;
+
+		m_Types.clear();
+		m_Offsets.clear();
+		m_Data.clear();
+		m_Literals.clear();
+	}
+
+	void TokenStream::Reserve(size_t count)
+	{
+		m_Types.reserve(count);
+		m_Offsets.reserve(count);
+		m_Data.reserve(count);
+	}
+
+	void TokenStream::Resize(size_t count, size_t literalCount)
+	{
+		m_Types.resize(count);
+		m_Offsets.resize(count);
+		m_Data.resize(count);
+		m_Literals.resize(literalCount);
+	}
+
+	void TokenStream::Assign(size_t index, size_t literalIndex, const TokenStream& other, const std::vector<SymbolId>& symbols)
+	{
+		std::copy(other.m_Types.begin(), other.m_Types.end(), m_Types.begin() + index);
+		std::copy(other.m_Offsets.begin(), other.m_Offsets.end(), m_Offsets.begin() + index);
+		std::copy(other.m_Literals.begin(), other.m_Literals.end(), m_Literals.begin() + literalIndex);
+
+		for (size_t i = 0; i < other.Size(); i++)
+		{
+			if (other.m_Types[i] == TokenType::Identifier)
+				m_Data[index + i] = symbols[other.m_Data[i]];
+			else if (TokenIsLiteral(other.m_Types[i]))
+				m_Data[index + i] = other.m_Data[i] + static_cast<uint32_t>(literalIndex);
+			else
+				m_Data[index + i] = other.m_Data[i];
+		}
+	}
+
+	void TokenStream::Push(TokenType type, uint32_t offset, uint32_t length)
+	{
+		m_Types.push_back(type);
+		m_Offsets.push_back(offset);
+		m_Data.push_back(length);
+	}
+
+	void TokenStream::PushIdentifier(uint32_t offset, SymbolId symbol)
+	{
+		Push(TokenType::Identifier, offset, symbol);
+	}
+
+	void TokenStream::PushLiteral(TokenType type, uint32_t offset, uint32_t length, const ConstantValue& value)
+	{
+		Push(type, offset, static_cast<uint32_t>(m_Literals.size()));
+		m_Literals.emplace_back(value, length);
+	}
+
+	Token TokenStream::Get(size_t index) const
+	{
+		return Token(GetType(index), GetValue(index), GetLocation(index), GetSymbol(index));
+	}
+
+	std::string_view TokenStream::GetValue(size_t index) const
+	{
+		if (m_Types[index] == TokenType::Identifier)
+			return m_Symbols->GetName(m_Data[index]);
+		else if (TokenIsLiteral(m_Types[index]))
+			return m_Source.substr(m_Offsets[index], m_Literals[m_Data[index]].Length);
+
+		return m_Source.substr(m_Offsets[index], m_Data[index]);
+	}
+
+	size_t TokenStream::GetMemoryUsage() const
+	{
+		return (m_Types.capacity() * sizeof(TokenType)) + (m_Offsets.capacity() * sizeof(uint32_t)) + (m_Data.capacity() * sizeof(uint32_t)) + (m_Literals.capacity() * sizeof(Literal));
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Dynamite/Core/Interner.hpp"
+#include "Dynamite/Core/SourceLocation.hpp"
+
+#include "Dynamite/Tokens/Token.hpp"
+#include "Dynamite/Tokens/Constant.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <string_view>
+
+namespace Dynamite
+{
+
+	/////////////////////////////////////////////////////////////////
+	// TokenStream
+	/////////////////////////////////////////////////////////////////
+	// Note: Tokens are stored as a structure of arrays, the values
+	// are slices (offset & length) into the source buffer. So the
+	// source has to outlive the stream and everything created from it.
+	// Identifiers store their SymbolId instead of a length, their
+	// value is the interned name. Literals store an index into the
+	// decoded constants. Locations are the offset added to the
+	// location of the start of the source.
+	class TokenStream
+	{
+	public:
+		TokenStream() = default;
+		~TokenStream() = default;
+
+		void Clear(std::string_view source = {}, const Interner* symbols = nullptr, SourceLocation base = {});
+		void Reserve(size_t count);
+		// Note: New tokens & literals have to be filled with Assign.
+		void Resize(size_t count, size_t literalCount);
+
+		// Copies all tokens of other to [index, index + other.Size()) and its literals to
+		// [literalIndex, literalIndex + other.LiteralCount()), symbols maps the SymbolId's
+		// of other to SymbolId's of this stream.
+		// Note: Writes to distinct ranges can be done from different threads.
+		void Assign(size_t index, size_t literalIndex, const TokenStream& other, const std::vector<SymbolId>& symbols);
+
+		void Push(TokenType type, uint32_t offset, uint32_t length);
+		void PushIdentifier(uint32_t offset, SymbolId symbol);
+		void PushLiteral(TokenType type, uint32_t offset, uint32_t length, const ConstantValue& value);
+
+		// Getters
+		[[nodiscard]] Token Get(size_t index) const;
+
+		inline TokenType GetType(size_t index) const { return m_Types[index]; }
+		std::string_view GetValue(size_t index) const;
+		inline uint32_t GetOffset(size_t index) const { return m_Offsets[index]; }
+		inline SymbolId GetSymbol(size_t index) const { return (m_Types[index] == TokenType::Identifier ? m_Data[index] : InvalidSymbol); }
+		// Note: Only valid for literals.
+		inline const ConstantValue& GetConstant(size_t index) const { return m_Literals[m_Data[index]].Value; }
+		inline SourceLocation GetLocation(size_t index) const { return { m_Base.Offset + m_Offsets[index] }; }
+
+		inline size_t Size() const { return m_Types.size(); }
+		inline bool Empty() const { return m_Types.empty(); }
+		inline size_t LiteralCount() const { return m_Literals.size(); }
+
+		inline std::string_view GetSource() const { return m_Source; }
+		inline const Interner& GetSymbols() const { return *m_Symbols; }
+
+		// Returns the amount of bytes used by the token storage
+		size_t GetMemoryUsage() const;
+
+	private:
+		std::string_view m_Source = {};
+		const Interner* m_Symbols = nullptr;
+		SourceLocation m_Base = {};
+
+		std::vector<TokenType> m_Types = { };
+		std::vector<uint32_t> m_Offsets = { };
+		std::vector<uint32_t> m_Data = { }; // Length, SymbolId or literal index
+
+		struct Literal
+		{
+		public:
+			ConstantValue Value = {};
+			uint32_t Length = 0;
+		};
+		std::vector<Literal> m_Literals = { };
+	};
+
+}
\ No newline at end of file
@@ -3,319 +3,522 @@
 
 #include "Dynamite/Core/Logging.hpp"
 
+#include "Dynamite/Tokens/Keywords.hpp"
+#include "Dynamite/Tokens/Scanning.hpp"
+
 #include "Dynamite/Parsing/Variables.hpp"
 
 #include "Dynamite/Compiler/CompilerSuite.hpp"
 
+#include <Pulse/Text/Format.hpp>
+
+#include <array>
+#include <string_view>
+
 namespace Dynamite
 {
 
     namespace
     {
-        static bool IsAlpha(char c)
+        /////////////////////////////////////////////////////////////////
+        // Character classes
+        /////////////////////////////////////////////////////////////////
+        enum class CharClass : uint8_t
         {
-            return (std::isalpha(c) || c == '_');
-        }
+            Invalid = 0,
+
+            Whitespace,         // ' ', '\t', '\n', '\v', '\f', '\r'
+            Alpha,              // [a-zA-Z_]
+            Digit,              // [0-9]
+            Minus,              // '-'
+            Dot,                // '.'
+            Apostrophe,         // '\''
+            Quote,              // '"'
+            Slash,              // '/'
+            Operator,           // Operator tokens, see s_OperatorTokens & s_DoubleOperatorTokens
+
+            Count
+        };
+
+        constexpr const std::array<TokenType, 256> s_OperatorTokens = []()
+        {
+            std::array<TokenType, 256> tokens = { };
 
-        static bool IsNumeric(char c, bool allowsMinus)
+            for (char c : std::string_view(";(){}=+*|&^<>"))
+                tokens[static_cast<uint8_t>(c)] = static_cast<TokenType>(c);
+
+            return tokens;
+        }();
+
+        // Note: Two char operators are `=` or their first char repeated after
+        // the first char, indexed by the first char.
+        constexpr const std::array<TokenType, 256> s_DoubleOperatorTokens = []()
         {
-            return (std::isdigit(c) || (allowsMinus ? (c == '-') : false));
-        }
+            std::array<TokenType, 256> tokens = { };
+
+            tokens['='] = TokenType::EqualsEquals;
+            tokens['!'] = TokenType::ExclamationEquals;
+            tokens['<'] = TokenType::LessThanEquals;
+            tokens['>'] = TokenType::GreaterThanEquals;
+            tokens['&'] = TokenType::AndAnd;
+            tokens['|'] = TokenType::PipePipe;
+
+            return tokens;
+        }();
+
+        constexpr const std::array<char, 256> s_DoubleOperatorChars = []()
+        {
+            std::array<char, 256> chars = { };
+
+            for (char c : std::string_view("=!<>"))
+                chars[static_cast<uint8_t>(c)] = '=';
+            for (char c : std::string_view("&|"))
+                chars[static_cast<uint8_t>(c)] = c;
+
+            return chars;
+        }();
+
+        constexpr const std::array<CharClass, 256> s_CharClasses = []()
+        {
+            std::array<CharClass, 256> classes = { };
+
+            for (char c : std::string_view(" \t\n\v\f\r"))
+                classes[static_cast<uint8_t>(c)] = CharClass::Whitespace;
+
+            for (size_t c = 'a'; c <= 'z'; c++)
+                classes[c] = CharClass::Alpha;
+            for (size_t c = 'A'; c <= 'Z'; c++)
+                classes[c] = CharClass::Alpha;
+            classes['_'] = CharClass::Alpha;
+
+            for (size_t c = '0'; c <= '9'; c++)
+                classes[c] = CharClass::Digit;
 
-        static bool IsAlphaNumeric(char c)
+            classes['-'] = CharClass::Minus;
+            classes['.'] = CharClass::Dot;
+            classes['\''] = CharClass::Apostrophe;
+            classes['"'] = CharClass::Quote;
+            classes['/'] = CharClass::Slash;
+
+            for (size_t c = 0; c < s_OperatorTokens.size(); c++)
+            {
+                if (s_OperatorTokens[c] != TokenType::None || s_DoubleOperatorTokens[c] != TokenType::None)
+                    classes[c] = CharClass::Operator;
+            }
+
+            return classes;
+        }();
+
+        static CharClass GetCharClass(char c)
         {
-            return IsAlpha(c) || IsNumeric(c, false);
+            return s_CharClasses[static_cast<uint8_t>(c)];
         }
+
+        /////////////////////////////////////////////////////////////////
+        // Number DFA
+        /////////////////////////////////////////////////////////////////
+        // Note: Accepts -?[0-9]+(\.[0-9]*)? where a lone '-' is the minus operator.
+        enum class NumberState : uint8_t
+        {
+            Done = 0,
+
+            Sign,           // '-'
+            Integer,        // -?[0-9]+
+            Float,          // -?[0-9]+\.[0-9]*
+
+            Count
+        };
+
+        constexpr const auto s_NumberTransitions = []()
+        {
+            std::array<std::array<NumberState, static_cast<size_t>(CharClass::Count)>, static_cast<size_t>(NumberState::Count)> table = { };
+
+            table[static_cast<size_t>(NumberState::Sign)][static_cast<size_t>(CharClass::Digit)] = NumberState::Integer;
+
+            table[static_cast<size_t>(NumberState::Integer)][static_cast<size_t>(CharClass::Digit)] = NumberState::Integer;
+            table[static_cast<size_t>(NumberState::Integer)][static_cast<size_t>(CharClass::Dot)] = NumberState::Float;
+
+            table[static_cast<size_t>(NumberState::Float)][static_cast<size_t>(CharClass::Digit)] = NumberState::Float;
+
+            return table;
+        }();
+
+        constexpr const std::array<TokenType, static_cast<size_t>(NumberState::Count)> s_NumberTokens = { TokenType::None, TokenType::Minus, TokenType::IntegerLiteral, TokenType::FloatLiteral };
+
+        /////////////////////////////////////////////////////////////////
+        // Parallel tokenization
+        /////////////////////////////////////////////////////////////////
+        // Note: Below this size splitting costs more than it saves.
+        constexpr static const size_t s_MinParallelSize = 1ull * 1024 * 1024; // 1 MB
+        constexpr static const size_t s_MinChunkSize = 256ull * 1024; // 256 KB
+
+        // Note: Every chunk starts right after a newline and is speculatively
+        // tokenized as if it doesn't start inside a string or comment.
+        struct Chunk
+        {
+        public:
+            size_t Begin = 0;
+            size_t End = 0;
+            size_t Stop = 0; // Index after the last token, > End if it crossed into the next chunk
+
+            TokenStream Tokens = { };
+            Interner Symbols = { };
+            std::vector<uint32_t> LineStarts = { };
+            std::vector<std::pair<size_t, std::string>> Errors = { };
+        };
     }
 
     /////////////////////////////////////////////////////////////////
     // Main functions
     /////////////////////////////////////////////////////////////////
-    Tokenizer::Tokenizer(std::string& fileContent)
-        : m_FileContent(fileContent)
+    Tokenizer::Tokenizer(SourceManager& sources, TokenStream& tokens, Interner& symbols, ThreadPool& threadPool)
+        : m_Sources(sources), m_ThreadPool(threadPool), m_Tokens(tokens), m_Symbols(symbols)
     {
     }
 
-    std::vector<Token> Tokenizer::Tokenize()
+    void Tokenizer::Tokenize(FileId file)
     {
-        m_Tokens.clear();
-        m_Buffer.clear();
-        m_LineNumber = 1;
+        Begin(file);
 
-        while (Peek(0).has_value())
-        {
-            // Is alphabetic
-            if (PeekCheck(IsAlpha)) // Note: Also handles boolean values
-            {
-                m_Buffer.push_back(Consume());
+        if (m_ThreadPool.Size() > 1 && m_FileContent.size() >= s_MinParallelSize)
+            TokenizeParallel();
+        else
+            TokenizeRange(0, m_FileContent.size());
+    }
 
-                // While is alphabetic or a number, keep reading
-                while (PeekCheck(IsAlphaNumeric))
-                    m_Buffer.push_back(Consume());
+    void Tokenizer::BeginStream(FileId file)
+    {
+        Begin(file);
+    }
 
-                // If no type is found, try keywords.
-                if (!HandleTypes())
-                    HandleKeywords();
-            }
+    bool Tokenizer::Next(Token& token, ConstantValue& constant)
+    {
+        // Note: The TokenStream only ever holds the token that is being handed out.
+        m_Tokens.Clear(m_FileContent, &m_Symbols, m_Sources.GetLocation(m_File, 0));
 
-            // Is number
-            else if (PeekCheck(IsNumeric, true))
-            {
-                m_Buffer.push_back(Consume());
-
-                // While still a numeric value, keep reading
-                while (PeekCheck(IsNumeric, false))
-                    m_Buffer.push_back(Consume());
-
-                // If buffer is just a minus, make it a minus
-                if (m_Buffer == "-")
-                {
-                    m_Tokens.emplace_back(TokenType::Minus, m_LineNumber);
-                    m_Buffer.clear();
-                    continue;
-                }
-
-                if (Peek(0).has_value() && (Peek(0).value() == '.'))
-                {
-                    m_Buffer.push_back(Consume()); // '.' char
-
-                    while (PeekCheck(IsNumeric, false))
-                        m_Buffer.push_back(Consume());
-
-                    m_Tokens.emplace_back(TokenType::FloatLiteral, m_Buffer, m_LineNumber);
-                    m_Buffer.clear();
-                }
-                else // Else it's just an integer literal
-                {
-                    m_Tokens.emplace_back(TokenType::IntegerLiteral, m_Buffer, m_LineNumber);
-                    m_Buffer.clear();
-                }
-            }
+        while (m_Tokens.Empty() && m_Index < m_FileContent.size())
+            TokenizeNext(m_FileContent);
 
-            // Is char
-            else if (Peek(0).has_value() && Peek(0).value() == '\'' // Begin char character
-                && Peek(2).has_value() && Peek(2).value() == '\'') // End char character
-            {
-                Consume(); // ''' Start char character
-                m_Buffer.push_back(Consume()); // Char character
-                Consume(); // ''' End char character
+        if (m_Tokens.Empty())
+            return false;
 
-                m_Tokens.emplace_back(TokenType::CharLiteral, m_Buffer, m_LineNumber);
-                m_Buffer.clear();
-            }
+        token = m_Tokens.Get(0);
+        if (TokenIsLiteral(token.Type))
+            constant = m_Tokens.GetConstant(0);
 
-            // Is string // Note: String buffer keeps '\'s
-            else if (Peek(0).has_value() && Peek(0).value() == '"')
-            {
-                Consume(); // '"' Start string character
+        return true;
+    }
 
-                bool contin = Peek(0).has_value() && Peek(0).value() != '"';
-                while (contin)
-                {
-                    m_Buffer.push_back(Consume());
+    void Tokenizer::Begin(FileId file)
+    {
+        // Note: The SourceManager makes sure every offset fits in 32 bits.
+        m_File = file;
+        m_FileContent = m_Sources.GetContent(file);
+        m_LineStarts = &m_Sources.ResetLineStarts(file);
 
-                    if (Peek(0).has_value() && Peek(0).value() == '"' && Peek(-1).value() != '\\')
-                        contin = false;
-                }
+        m_Tokens.Clear(m_FileContent, &m_Symbols, m_Sources.GetLocation(file, 0));
+        m_Index = 0;
+    }
 
-                Consume(); // '"' End string character
+    size_t Tokenizer::TokenizeRange(size_t begin, size_t end)
+    {
+        // Note: Whitespace is the only run that can end exactly at the end of the range.
+        const std::string_view range = m_FileContent.substr(0, end);
 
-                m_Tokens.emplace_back(TokenType::StringLiteral, m_Buffer, m_LineNumber);
-                m_Buffer.clear();
-            }
+        m_Index = begin;
+        while (m_Index < end)
+            TokenizeNext(range);
+
+        return m_Index;
+    }
 
-            // Single line comment
-            else if (Peek(0).value() == '/' && Peek(1).has_value() && Peek(1).value() == '/') 
+    void Tokenizer::TokenizeNext(std::string_view range)
+    {
+        const std::string_view content = m_FileContent;
+        const char c = content[m_Index];
+
+        switch (GetCharClass(c))
+        {
+        // Whitespace & newlines (for incrementing)
+        case CharClass::Whitespace:
+        {
+            m_Index = Scanning::SkipWhitespace(range, m_Index, *m_LineStarts);
+            break;
+        }
+
+        // Is alphabetic // Note: Also handles boolean values
+        case CharClass::Alpha:
+        {
+            // While is alphabetic or a number, keep reading
+            const size_t start = m_Index;
+            m_Index = Scanning::SkipIdentifier(content, m_Index + 1);
+
+            // Types, keywords or identifier
+            HandleKeywords(start);
+            break;
+        }
+
+        // Is number (or minus)
+        case CharClass::Digit:
+        case CharClass::Minus:
+        {
+            const size_t start = m_Index;
+            NumberState state = (c == '-' ? NumberState::Sign : NumberState::Integer);
+
+            while (true)
             {
-                Consume(); // '/' char
-                Consume(); // '/' char
+                m_Index++;
 
-                while (Peek(0).has_value() && (Peek(0).value() != '\n' && Peek(0).value() != '\r'))
-                    Consume();
+                const NumberState next = (m_Index < content.size() ? s_NumberTransitions[static_cast<size_t>(state)][static_cast<size_t>(GetCharClass(content[m_Index]))] : NumberState::Done);
+                if (next == NumberState::Done)
+                    break;
 
-                Consume(); // '\n' char
-                m_LineNumber++;
+                state = next;
             }
-            // Multiline comment
-            else if (Peek(0).value() == '/' && Peek(1).has_value() && Peek(1).value() == '*')
+
+            PushToken(s_NumberTokens[static_cast<size_t>(state)], start, m_Index - start);
+            break;
+        }
+
+        // Is char
+        case CharClass::Apostrophe:
+        {
+            if (m_Index + 2 < content.size() && content[m_Index + 2] == '\'') // End char character
             {
-                Consume(); // '/' char
-                Consume(); // '*' char
-
-                while (Peek(0).has_value()) 
-                {
-                    if (Peek(0).value() == '*' && Peek(1).has_value() && Peek(1).value() == '/')
-                    {
-                        Consume(); // '*' char
-                        Consume(); // '/' char
-                        break;
-                    }
-                    else if ((Peek(0).value() == '\n' || Peek(0).value() == '\r'))
-                        m_LineNumber++;
-
-                    Consume();
-                }
+                PushToken(TokenType::CharLiteral, m_Index + 1, 1);
+                m_Index += 3;
             }
+            else
+                HandleInvalid();
+            break;
+        }
+
+        // Is string // Note: String buffer keeps '\'s
+        case CharClass::Quote:
+        {
+            // Note: The first character can never end the string, unless the string is empty.
+            const size_t start = ++m_Index;
+            if (m_Index < content.size() && content[m_Index] != '"')
+                m_Index = Scanning::FindStringEnd(content, m_Index + 1);
 
-            // Handle operators and other chars
-            else if (HandleOperators())
-                continue;
+            PushToken(TokenType::StringLiteral, start, m_Index - start);
 
-            // Invalid token
+            // Note: Strings can span multiple lines.
+            const std::string_view string = content.substr(0, m_Index);
+            for (size_t i = Scanning::FindLineEnd(string, start); i < string.size(); i = Scanning::FindLineEnd(string, i + 1))
+                m_LineStarts->push_back(static_cast<uint32_t>(i + 1));
+
+            if (m_Index < content.size())
+                m_Index++; // '"' End string character
             else
+                ReportError(start - 1, "Unterminated string literal.");
+            break;
+        }
+
+        // Comments or divide
+        case CharClass::Slash:
+        {
+            const char next = (m_Index + 1 < content.size() ? content[m_Index + 1] : '\0');
+
+            // Single line comment // Note: The '\n' is left for the whitespace handling.
+            if (next == '/')
             {
-                CompilerSuite::Error(m_LineNumber, "Invalid token found: {0}", Peek(0).value());
+                m_Index = Scanning::FindLineEnd(content, m_Index + 2);
+            }
+            // Multiline comment
+            else if (next == '*')
+            {
+                m_Index = Scanning::FindBlockCommentEnd(content, m_Index + 2, *m_LineStarts);
 
-                // Consume() just 1 char, just to make sure we keep going.
-                // Since obviously from the previous char it was impossible to carry on.
-                Consume();
-                m_Buffer.clear();
+                if (m_Index < content.size())
+                    m_Index += 2; // '*/' chars
             }
+            else
+            {
+                PushToken(TokenType::Divide, m_Index, 1);
+                m_Index++;
+            }
+            break;
         }
 
-        return m_Tokens;
-    }
-
-    /////////////////////////////////////////////////////////////////
-    // Peeking & consuming
-    /////////////////////////////////////////////////////////////////
-    std::optional<char> Tokenizer::Peek(size_t offset) const
-    {
-        if (m_Index + offset >= m_FileContent.size())
-            return {};
+        // Operators
+        case CharClass::Operator:
+        {
+            const char next = (m_Index + 1 < content.size() ? content[m_Index + 1] : '\0');
 
-        return m_FileContent.at(m_Index + offset);
-    }
+            if (s_DoubleOperatorTokens[static_cast<uint8_t>(c)] != TokenType::None && next == s_DoubleOperatorChars[static_cast<uint8_t>(c)])
+            {
+                PushToken(s_DoubleOperatorTokens[static_cast<uint8_t>(c)], m_Index, 2);
+                m_Index += 2;
+            }
+            // Note: A `!` on its own isn't an operator (yet).
+            else if (s_OperatorTokens[static_cast<uint8_t>(c)] != TokenType::None)
+            {
+                PushToken(s_OperatorTokens[static_cast<uint8_t>(c)], m_Index, 1);
+                m_Index++;
+            }
+            else
+                HandleInvalid();
+            break;
+        }
 
-    char Tokenizer::Consume()
-    {
-        return m_FileContent.at(m_Index++);
+        // Invalid token
+        default:
+        {
+            HandleInvalid();
+            break;
+        }
+        }
     }
 
-    /////////////////////////////////////////////////////////////////
-    // Handling functions
-    /////////////////////////////////////////////////////////////////
-    bool Tokenizer::HandleTypes()
+    void Tokenizer::TokenizeParallel()
     {
-        // Note: It's okay to use if instead of else if, since
-        // we return from the function if it has been found.
-        #define HandleType(tokenType)                                               \
-            if (m_Buffer == ValueTypeToStr(static_cast<ValueType>(tokenType)))      \
-            {                                                                       \
-                m_Tokens.emplace_back(tokenType, m_LineNumber);                     \
-                m_Buffer.clear();                                                   \
-                return true;                                                        \
-            }
+        const std::string_view content = m_FileContent;
+        const SourceLocation base = m_Sources.GetLocation(m_File, 0);
 
-        HandleType(TokenType::Bool);
+        // Split the content into chunks that start after a newline
+        const size_t chunkSize = std::max(s_MinChunkSize, content.size() / (m_ThreadPool.Size() * 4));
 
-        HandleType(TokenType::Int8);
-        HandleType(TokenType::Int16);
-        HandleType(TokenType::Int32);
-        HandleType(TokenType::Int64);
+        std::vector<size_t> boundaries = { 0 };
+        while (boundaries.back() + chunkSize < content.size())
+        {
+            const size_t lineEnd = Scanning::FindLineEnd(content, boundaries.back() + chunkSize);
+            if (lineEnd + 1 >= content.size())
+                break;
 
-        HandleType(TokenType::UInt8);
-        HandleType(TokenType::UInt16);
-        HandleType(TokenType::UInt32);
-        HandleType(TokenType::UInt64);
+            boundaries.push_back(lineEnd + 1);
+        }
+        boundaries.push_back(content.size());
 
-        HandleType(TokenType::Float32);
-        HandleType(TokenType::Float64);
+        std::vector<Chunk> chunks(boundaries.size() - 1);
+        auto tokenizeChunk = [&](Chunk& chunk, size_t begin)
+        {
+            chunk.Begin = begin;
+            chunk.Tokens.Clear(content, &chunk.Symbols, base);
+            chunk.Symbols.Clear();
+            chunk.LineStarts.clear();
+            chunk.Errors.clear();
+
+            Tokenizer tokenizer(m_Sources, chunk.Tokens, chunk.Symbols, m_ThreadPool);
+            tokenizer.m_File = m_File;
+            tokenizer.m_FileContent = content;
+            tokenizer.m_LineStarts = &chunk.LineStarts;
+            tokenizer.m_DeferredErrors = &chunk.Errors;
+
+            chunk.Stop = (begin < chunk.End ? tokenizer.TokenizeRange(begin, chunk.End) : begin);
+        };
+
+        m_ThreadPool.ParallelFor(chunks.size(), [&](size_t i)
+        {
+            chunks[i].End = boundaries[i + 1];
+            tokenizeChunk(chunks[i], boundaries[i]);
+        });
+
+        // Note: If the previous chunk stopped past our start, we started inside of
+        // a string, comment or char and have to be tokenized again from its stop.
+        size_t position = 0;
+        for (auto& chunk : chunks)
+        {
+            if (chunk.Begin != position)
+                tokenizeChunk(chunk, position);
 
-        HandleType(TokenType::Char);
-        HandleType(TokenType::String);
+            position = chunk.Stop;
+        }
 
-        return false;
-    }
+        // Stitch the chunks together
+        // Note: Symbols are interned in chunk order, so they get the same ids as with serial tokenization.
+        std::vector<std::vector<SymbolId>> symbols(chunks.size());
+        std::vector<size_t> tokenOffsets(chunks.size());
+        std::vector<size_t> literalOffsets(chunks.size());
+        size_t tokenCount = 0;
+        size_t literalCount = 0;
 
-    void Tokenizer::HandleKeywords()
-    {
-        // If / Else
-        if (m_Buffer == "if")
+        for (size_t i = 0; i < chunks.size(); i++)
         {
-            m_Tokens.emplace_back(TokenType::If, m_LineNumber);
-            m_Buffer.clear();
-            return;
-        }
-        if (m_Buffer == "else")
-        {
-            m_Tokens.emplace_back(TokenType::Else, m_LineNumber);
-            m_Buffer.clear();
-            return;
+            symbols[i].reserve(chunks[i].Symbols.Size());
+            for (SymbolId symbol = 0; symbol < chunks[i].Symbols.Size(); symbol++)
+                symbols[i].push_back(m_Symbols.Intern(chunks[i].Symbols.GetName(symbol)));
+
+            tokenOffsets[i] = tokenCount;
+            tokenCount += chunks[i].Tokens.Size();
+            literalOffsets[i] = literalCount;
+            literalCount += chunks[i].Tokens.LiteralCount();
+
+            m_LineStarts->insert(m_LineStarts->end(), chunks[i].LineStarts.begin(), chunks[i].LineStarts.end());
         }
 
-        // Boolean values
-        if (m_Buffer == "false")
+        m_Tokens.Resize(tokenCount, literalCount);
+        m_ThreadPool.ParallelFor(chunks.size(), [&](size_t i)
         {
-            m_Tokens.emplace_back(TokenType::BoolLiteral, "0", m_LineNumber);
-            m_Buffer.clear();
-            return;
-        }
-        if (m_Buffer == "true")
+            m_Tokens.Assign(tokenOffsets[i], literalOffsets[i], chunks[i].Tokens, symbols[i]);
+        });
+
+        // Note: Errors are reported after the line table is complete.
+        for (const auto& chunk : chunks)
         {
-            m_Tokens.emplace_back(TokenType::BoolLiteral, "1", m_LineNumber);
-            m_Buffer.clear();
-            return;
+            for (const auto& [offset, message] : chunk.Errors)
+                ReportError(offset, message);
         }
 
-        // Exit function // TODO: Make reusable for all functions
-        if (m_Buffer == "exit")
+        m_Index = content.size();
+    }
+
+    /////////////////////////////////////////////////////////////////
+    // Handling functions
+    /////////////////////////////////////////////////////////////////
+    void Tokenizer::HandleKeywords(size_t start)
+    {
+        const uint32_t length = static_cast<uint32_t>(m_Index - start);
+        const std::string_view name = m_FileContent.substr(start, length);
+
+        // Types & keywords
+        if (const Keyword* keyword = FindKeyword(name))
         {
-            m_Tokens.emplace_back(TokenType::Exit, m_LineNumber);
-            m_Buffer.clear();
+            PushToken(keyword->Type, start, length);
             return;
         }
 
         // Else we say its an Identifier
-        m_Tokens.emplace_back(TokenType::Identifier, m_Buffer, m_LineNumber);
-        m_Buffer.clear();
+        m_Tokens.PushIdentifier(static_cast<uint32_t>(start), m_Symbols.Intern(name));
     }
 
-    bool Tokenizer::HandleOperators()
+    void Tokenizer::HandleInvalid()
     {
-        // Note: It's okay to use if instead of else if, since
-        // we return from the function if it has been found.
-        #define CharOperator(c, tokenType)                      \
-            if (Peek().value() == c)                            \
-            {                                                   \
-                Consume();                                      \
-                m_Tokens.emplace_back(tokenType, m_LineNumber); \
-                return true;                                    \
-            }
+        ReportError(m_Index, Pulse::Text::Format("Invalid token found: {0}", m_FileContent[m_Index]));
 
-        // Signs
-        CharOperator(';', TokenType::Semicolon);
-        CharOperator('(', TokenType::OpenParenthesis);
-        CharOperator(')', TokenType::CloseParenthesis);
-        CharOperator('{', TokenType::OpenCurlyBrace);
-        CharOperator('}', TokenType::CloseCurlyBrace);
-        CharOperator('=', TokenType::Equals);
-
-        // Operators
-        CharOperator('+', TokenType::Plus);
-        CharOperator('-', TokenType::Minus);
-        CharOperator('*', TokenType::Star);
-        CharOperator('/', TokenType::Divide);
-
-        CharOperator('|', TokenType::Or);
-        CharOperator('&', TokenType::And);
-        CharOperator('^', TokenType::Xor);
+        // Skip just 1 char, just to make sure we keep going.
+        // Since obviously from the previous char it was impossible to carry on.
+        m_Index++;
+    }
 
-        // Newline (for incrementing)
-        if (Peek().value() == '\n' || Peek().value() == '\r')
+    void Tokenizer::PushToken(TokenType type, size_t offset, size_t length)
+    {
+        if (!TokenIsLiteral(type))
         {
-            Consume();
-            m_LineNumber++;
-            return true;
+            m_Tokens.Push(type, static_cast<uint32_t>(offset), static_cast<uint32_t>(length));
+            return;
         }
-        // Space
-        if (std::isspace(Peek().value()))
+
+        // Note: Literals are decoded once here, so nothing after us has to reparse them.
+        const std::string_view value = m_FileContent.substr(offset, length);
+
+        bool dataLost = false;
+        const ConstantValue constant = GetConstantValue(type, value, &dataLost);
+        if (dataLost)
+            ReportError(offset, Pulse::Text::Format("Literal {0} doesn't fit in any type, clamped to {1}.", value, FormatConstantValue(constant)));
+
+        m_Tokens.PushLiteral(type, static_cast<uint32_t>(offset), static_cast<uint32_t>(length), constant);
+    }
+
+    void Tokenizer::ReportError(size_t offset, const std::string& message)
+    {
+        if (m_DeferredErrors)
         {
-            Consume();
-            return true;
+            m_DeferredErrors->emplace_back(offset, message);
+            return;
         }
 
-        return false;
+        CompilerSuite::Error(m_Sources.GetLocation(m_File, static_cast<uint32_t>(offset)), "{0}", message);
     }
 
-}
+}
\ No newline at end of file
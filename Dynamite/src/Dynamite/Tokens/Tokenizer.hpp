@@ -1,63 +1,81 @@
 #pragma once
 
+#include "Dynamite/Core/Interner.hpp"
+#include "Dynamite/Core/SourceLocation.hpp"
+#include "Dynamite/Core/ThreadPool.hpp"
+
+#include "Dynamite/Compiler/SourceManager.hpp"
+
 #include "Dynamite/Tokens/Token.hpp"
+#include "Dynamite/Tokens/TokenStream.hpp"
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <optional>
-#include <functional>
 
 namespace Dynamite
 {
 
-	// Note: Only support single file tokenization
+	// Note: Only support single file tokenization, large files are
+	// split into chunks which get tokenized on the thread pool.
 	class Tokenizer
 	{
 	public:
-		Tokenizer(std::string& fileContent);
+		Tokenizer(SourceManager& sources, TokenStream& tokens, Interner& symbols, ThreadPool& threadPool);
 		~Tokenizer() = default;
 
-		std::vector<Token> Tokenize();
+		// Note: Fills the TokenStream passed in at construction and
+		// the line table of the file in the SourceManager.
+		void Tokenize(FileId file);
+
+		// Note: Prepares the file for on demand tokenization, tokens are then
+		// pulled one by one with Next() so the whole file never gets stored.
+		void BeginStream(FileId file);
+		// Tokenizes up to the next token, returns false at the end of the file.
+		// Note: constant is only set for literals.
+		bool Next(Token& token, ConstantValue& constant);
 
 		// Getters
 		inline const size_t GetIndex() const { return m_Index; }
+		inline const FileId GetFile() const { return m_File; }
 
-		inline const std::vector<Token>& GetTokens() const { return m_Tokens; }
-		inline const std::string& GetBuffer() const { return m_Buffer; }
-		inline const uint32_t GetLineNumber() const { return m_LineNumber; }
+		inline const TokenStream& GetTokens() const { return m_Tokens; }
+		inline SourceLocation GetLocation() const { return m_Sources.GetLocation(m_File, static_cast<uint32_t>(m_Index)); }
 
 	public:
-		// Returns the char at m_Index + offset, if it is out of bounds it
-		// will return an optional with no value. Checkable with .has_value()
-		[[nodiscard]] std::optional<char> Peek(size_t offset = 0) const;
+		void HandleKeywords(size_t start);
+		void HandleInvalid();
 
-        template<typename Func, typename ...Args>
-        [[nodiscard]] bool PeekCheck(Func&& func, Args&& ...args);
+	private:
+		void Begin(FileId file);
 
-		// Increments the index and returns the character at m_Index
-		char Consume();
+		// Tokenizes every token that starts in [begin, end) and returns the index after the last one.
+		// Note: Strings & comments can continue past end, so the returned index can be past end.
+		size_t TokenizeRange(size_t begin, size_t end);
+		// Tokenizes the token, whitespace or comment that starts at m_Index.
+		void TokenizeNext(std::string_view range);
+		void TokenizeParallel();
 
-		/////////////////////////////////////////////////////////////////
-		bool HandleTypes();
-		void HandleKeywords();
-		bool HandleOperators();
+		void PushToken(TokenType type, size_t offset, size_t length);
+		void ReportError(size_t offset, const std::string& message);
 
 	private:
-		std::string& m_FileContent;
+		SourceManager& m_Sources;
+		ThreadPool& m_ThreadPool;
+		FileId m_File = InvalidFile;
+
+		std::string_view m_FileContent = {};
 		size_t m_Index = 0;
 
 		// Token usage
-		std::vector<Token> m_Tokens = { };
-		std::string m_Buffer = {};
-		uint32_t m_LineNumber = 1;
-	};
+		TokenStream& m_Tokens;
+		Interner& m_Symbols;
+		std::vector<uint32_t>* m_LineStarts = nullptr;
 
-    template<typename Func, typename ...Args>
-    bool Tokenizer::PeekCheck(Func&& func, Args&& ...args)
-    {
-        auto peeked = Peek();
-        return peeked.has_value() && func(peeked.value(), std::forward<Args>(args)...);
-    }
+		// Note: Only set while tokenizing a chunk, since a chunk can turn out
+		// to be tokenized from the wrong start its errors are reported later.
+		std::vector<std::pair<size_t, std::string>>* m_DeferredErrors = nullptr;
+	};
 
 }